@@ -26,7 +26,9 @@ public class DynamicTimers : ModuleRules
 			new string[]
 			{
 				"Core", 
+				"DeveloperSettings",
 				"GameplayTags",
+				"NetCore",
 				// ... add other public dependencies that you statically link with here ...
 			}
 			);
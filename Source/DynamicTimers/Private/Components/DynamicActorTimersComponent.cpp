@@ -0,0 +1,170 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Components/DynamicActorTimersComponent.h"
+
+#include "Components/DynamicTimersComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/GameStateBase.h"
+#include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
+#include "Subsystems/DynamicTimersSubsystem.h"
+
+UDynamicActorTimersComponent::UDynamicActorTimersComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+	SetIsReplicatedByDefault(true);
+}
+
+void UDynamicActorTimersComponent::PostInitProperties()
+{
+	Super::PostInitProperties();
+
+	ReplicatedTimers.Owner = this;
+}
+
+void UDynamicActorTimersComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+	DOREPLIFETIME_WITH_PARAMS_FAST(UDynamicActorTimersComponent, ReplicatedTimers, Params);
+}
+
+bool UDynamicActorTimersComponent::GetTimerRemainingTime(FGameplayTag TimerTag, float& RemainingTime) const
+{
+	const FTimeData* TimerData = ReplicatedTimers.Items.FindByPredicate([&TimerTag](const FTimeData& Item)
+	{
+		return Item.TimerTag == TimerTag;
+	});
+
+	RemainingTime = TimerData ? TimerData->GetRemainingTime(GetServerTime()) : 0.0f;
+	return TimerData != nullptr;
+}
+
+void UDynamicActorTimersComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (GetOwner()->HasAuthority())
+	{
+		if (UDynamicTimersSubsystem* Subsystem = UWorld::GetSubsystem<UDynamicTimersSubsystem>(GetWorld()))
+		{
+			Subsystem->AddBridge(*this);
+		}
+	}
+}
+
+void UDynamicActorTimersComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (GetOwner()->HasAuthority())
+	{
+		if (UDynamicTimersSubsystem* Subsystem = UWorld::GetSubsystem<UDynamicTimersSubsystem>(GetWorld()))
+		{
+			Subsystem->RemoveBridge(*this);
+		}
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UDynamicActorTimersComponent::UpsertTimer(const FTimeData& TimerData, bool bRestarted)
+{
+	// An actor only carries a handful of timers, a scan is cheaper than another index
+	FTimeData* ExistingTimer = ReplicatedTimers.Items.FindByPredicate([&TimerData](const FTimeData& Item)
+	{
+		return Item.TimerTag == TimerData.TimerTag;
+	});
+
+	if (ExistingTimer)
+	{
+		// The subsystem does not keep the count, it lives with the replicated copy
+		const uint8 RestartCount = ExistingTimer->RestartCount + (bRestarted ? 1 : 0);
+		ExistingTimer->CopyStateFrom(TimerData);
+		ExistingTimer->RestartCount = RestartCount;
+		ReplicatedTimers.MarkItemDirty(*ExistingTimer);
+		HandleTimerChanged(*ExistingTimer);
+	}
+	else
+	{
+		FTimeData& AddedTimer = ReplicatedTimers.Items.Add_GetRef(TimerData);
+		ReplicatedTimers.MarkItemDirty(AddedTimer);
+		HandleTimerAdded(AddedTimer);
+	}
+	MARK_PROPERTY_DIRTY_FROM_NAME(UDynamicActorTimersComponent, ReplicatedTimers, this);
+}
+
+void UDynamicActorTimersComponent::RemoveTimer(const FGameplayTag& TimerTag)
+{
+	const int32 Index = ReplicatedTimers.Items.IndexOfByPredicate([&TimerTag](const FTimeData& Item)
+	{
+		return Item.TimerTag == TimerTag;
+	});
+
+	if (Index != INDEX_NONE)
+	{
+		HandleTimerRemoved(ReplicatedTimers.Items[Index]);
+		ReplicatedTimers.Items.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+		ReplicatedTimers.MarkArrayDirty();
+		MARK_PROPERTY_DIRTY_FROM_NAME(UDynamicActorTimersComponent, ReplicatedTimers, this);
+	}
+}
+
+void UDynamicActorTimersComponent::HandleTimerAdded(FTimeData& TimerData)
+{
+	BroadcastTimerEvent(EDTTimerEvent::Registered, TimerData);
+	HandleTimerChanged(TimerData);
+}
+
+void UDynamicActorTimersComponent::HandleTimerChanged(FTimeData& TimerData)
+{
+	// A retrigger starts the timer over; its state is reported again from scratch, whatever else changed with it
+	if (TimerData.RestartCount != TimerData.NotifiedRestartCount)
+	{
+		TimerData.bNotifiedStarted = false;
+		TimerData.bNotifiedPaused = false;
+		TimerData.NotifiedRestartCount = TimerData.RestartCount;
+	}
+
+	if (TimerData.bIsStarted && !TimerData.bNotifiedStarted)
+	{
+		BroadcastTimerEvent(EDTTimerEvent::Started, TimerData);
+	}
+	TimerData.bNotifiedStarted = TimerData.bIsStarted;
+
+	if (TimerData.bIsPaused != TimerData.bNotifiedPaused)
+	{
+		BroadcastTimerEvent(TimerData.bIsPaused ? EDTTimerEvent::Paused : EDTTimerEvent::Resumed, TimerData);
+		TimerData.bNotifiedPaused = TimerData.bIsPaused;
+	}
+}
+
+void UDynamicActorTimersComponent::HandleTimerRemoved(const FTimeData& TimerData)
+{
+	BroadcastTimerEvent(EDTTimerEvent::Finished, TimerData);
+}
+
+void UDynamicActorTimersComponent::BroadcastTimerEvent(EDTTimerEvent Event, const FTimeData& TimerData) const
+{
+	OnTimerEvent.Broadcast({ Event, TimerData.TimerTag, TimerData.Duration, FGameplayTag(), INDEX_NONE });
+}
+
+double UDynamicActorTimersComponent::GetServerTime() const
+{
+	const UWorld* World = GetWorld();
+	if (!World) return 0.0;
+
+	if (GetOwner()->HasAuthority())
+	{
+		return World->GetTimeSeconds();
+	}
+
+	// The game state's timers component knows the synced clock
+	const AGameStateBase* GameState = World->GetGameState();
+	if (const UDynamicTimersComponent* TimersComponent = GameState ? GameState->FindComponentByClass<UDynamicTimersComponent>() : nullptr)
+	{
+		return TimersComponent->GetServerTime();
+	}
+	return GameState ? GameState->GetServerWorldTimeSeconds() : World->GetTimeSeconds();
+}
@@ -3,329 +3,1922 @@
 
 #include "Components/DynamicTimersComponent.h"
 
+#include "DynamicTimers.h"
+#include "Components/DynamicTimersPlayerComponent.h"
+#include "Data/DynamicTimerCatalog.h"
 #include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
+#include "Settings/DynamicTimersSettings.h"
 #include "Types/DTStructTypes.h"
+#include "Widgets/TimerDisplayWidget.h"
 #include "TimerManager.h"
 #include "Engine/World.h"
+#include "GameFramework/WorldSettings.h"
+#include "GameFramework/GameModeBase.h"
+#include "GameFramework/PlayerController.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+DECLARE_CYCLE_STAT(TEXT("Timer Mutation"), STAT_DynamicTimers_Mutation, STATGROUP_DynamicTimers);
+DECLARE_CYCLE_STAT(TEXT("Commit"), STAT_DynamicTimers_Commit, STATGROUP_DynamicTimers);
+DECLARE_CYCLE_STAT(TEXT("Expiry"), STAT_DynamicTimers_Expiry, STATGROUP_DynamicTimers);
+DECLARE_CYCLE_STAT(TEXT("Phase Boundaries"), STAT_DynamicTimers_Boundaries, STATGROUP_DynamicTimers);
+DECLARE_CYCLE_STAT(TEXT("Display Update"), STAT_DynamicTimers_DisplayUpdate, STATGROUP_DynamicTimers);
+DECLARE_CYCLE_STAT(TEXT("Publish Read Snapshot"), STAT_DynamicTimers_PublishSnapshot, STATGROUP_DynamicTimers);
+
+// Shows up under the function's name in Insights and adds to the given stat
+#define DYNAMICTIMERS_SCOPE(Name, Stat) \
+	TRACE_CPUPROFILER_EVENT_SCOPE(Name); \
+	SCOPE_CYCLE_COUNTER(Stat)
+
+namespace DynamicTimersPrivate
+{
+	// The state change alone, shared by the server and by predicting clients. False if it does not apply.
+	// Times are stored quantized, as they replicate.
+	bool ApplyOperation(FTimeData& TimerData, EDTTimerOperation Operation, double CurrentTime)
+	{
+		switch (Operation)
+		{
+		case EDTTimerOperation::Start:
+			if (TimerData.bIsStarted) return false;
+
+			TimerData.bIsStarted = true;
+			TimerData.StartTime = DynamicTimers::QuantizeNetTime(CurrentTime);
+			return true;
+
+		case EDTTimerOperation::Pause:
+		{
+			if (!TimerData.bIsStarted || TimerData.bIsPaused) return false;
+
+			double ElapsedTime = TimerData.GetElapsedTime(CurrentTime);
+			if (TimerData.bLooping)
+			{
+				// Only the position within the current loop matters, which keeps the float small
+				ElapsedTime = FMath::Fmod(ElapsedTime, static_cast<double>(TimerData.Duration));
+			}
+			TimerData.ElapsedTimeWhenPaused = static_cast<float>(DynamicTimers::QuantizeNetTime(ElapsedTime));
+			TimerData.bIsPaused = true;
+			return true;
+		}
+
+		case EDTTimerOperation::Resume:
+			if (!TimerData.bIsPaused) return false;
+
+			TimerData.bIsPaused = false;
+			TimerData.StartTime = DynamicTimers::QuantizeNetTime(CurrentTime - TimerData.ElapsedTimeWhenPaused / TimerData.Rate);
+			return true;
+
+		default:
+			return false;
+		}
+	}
+
+	bool IsTimerRelevantTo(const FTimeData& TimerData, const UDynamicTimersPlayerComponent& PlayerComponent)
+	{
+		switch (TimerData.Scope)
+		{
+		case EDTTimerScope::Player:
+			return TimerData.OwningPlayer.Get() == PlayerComponent.GetOwner();
+
+		case EDTTimerScope::Team:
+			return TimerData.TeamId != DynamicTimers::NoTeam && TimerData.TeamId == PlayerComponent.GetTimerTeamId();
+
+		default:
+			return false;
+		}
+	}
+}
+
+namespace DynamicTimersSnapshot
+{
+	// "DTSN"
+	constexpr uint32 Magic = 0x4E535444;
+
+	// Bump when the record layout changes; snapshots of versions this build does not know are rejected.
+	// Version 2 added thresholds, version 3 the delay of starts scheduled ahead.
+	constexpr int32 LatestVersion = 3;
+
+	enum ESnapshotFlags : uint8
+	{
+		Flag_Started = 1 << 0,
+		Flag_Paused = 1 << 1,
+		Flag_Looping = 1 << 2,
+		Flag_IgnoreTimeDilation = 1 << 3
+	};
+
+	struct FRestoredTimer
+	{
+		FTimeData TimerData;
+		double ElapsedTime = 0.0;
+		double StartDelay = 0.0;
+	};
+
+	// Tags travel by name, so a snapshot stays valid when the tag table of the next process is ordered differently
+	bool Read(const TArray<uint8>& Snapshot, TArray<FRestoredTimer>& OutTimers)
+	{
+		FMemoryReader Reader(Snapshot);
+
+		uint32 SnapshotMagic = 0;
+		int32 Version = 0;
+		Reader << SnapshotMagic << Version;
+		if (Reader.IsError() || SnapshotMagic != Magic || Version < 1 || Version > LatestVersion)
+		{
+			UE_LOG(LogDynamicTimers, Warning, TEXT("RestoreTimerSnapshot: not a timer snapshot, or one of an unknown version"));
+			return false;
+		}
+
+		uint32 NumTimers = 0;
+		Reader.SerializeIntPacked(NumTimers);
+
+		// Every record takes several bytes, a larger count can only come from a damaged snapshot
+		if (NumTimers > static_cast<uint32>(Snapshot.Num())) return false;
+		OutTimers.Reserve(NumTimers);
+
+		TArray<FDTTimerPhase> Phases;
+		TArray<float> Thresholds;
+		for (uint32 TimerIndex = 0; TimerIndex < NumTimers; ++TimerIndex)
+		{
+			FName TagName;
+			uint8 Flags = 0;
+			uint8 Scope = 0;
+			uint8 TeamId = DynamicTimers::NoTeam;
+			float Duration = 0.0f;
+			float TimeScale = 1.0f;
+			double ElapsedTime = 0.0;
+			uint32 NumPhases = 0;
+			Reader << TagName << Flags << Scope << TeamId << Duration << TimeScale << ElapsedTime;
+			Reader.SerializeIntPacked(NumPhases);
+
+			if (Reader.IsError() || NumPhases > DynamicTimers::MaxTimerPhases || Scope > static_cast<uint8>(EDTTimerScope::Team))
+			{
+				UE_LOG(LogDynamicTimers, Warning, TEXT("RestoreTimerSnapshot: snapshot is damaged"));
+				return false;
+			}
+
+			Phases.Reset();
+			for (uint32 PhaseIndex = 0; PhaseIndex < NumPhases; ++PhaseIndex)
+			{
+				FName PhaseName;
+				FDTTimerPhase& Phase = Phases.AddDefaulted_GetRef();
+				Reader << PhaseName << Phase.Duration;
+				Phase.PhaseTag = FGameplayTag::RequestGameplayTag(PhaseName, false);
+			}
+
+			Thresholds.Reset();
+			if (Version >= 2)
+			{
+				uint32 NumThresholds = 0;
+				Reader.SerializeIntPacked(NumThresholds);
+				if (NumThresholds > DynamicTimers::MaxTimerThresholds) return false;
+
+				Thresholds.SetNum(NumThresholds);
+				for (float& Threshold : Thresholds)
+				{
+					Reader << Threshold;
+				}
+			}
+
+			double StartDelay = 0.0;
+			if (Version >= 3)
+			{
+				Reader << StartDelay;
+			}
+			if (Reader.IsError()) return false;
+
+			FTimeData TimerData;
+			TimerData.TimerTag = FGameplayTag::RequestGameplayTag(TagName, false);
+			if (!TimerData.TimerTag.IsValid())
+			{
+				UE_LOG(LogDynamicTimers, Warning, TEXT("RestoreTimerSnapshot: %s is no longer a gameplay tag, its timer is dropped"), *TagName.ToString());
+				continue;
+			}
+
+			TimerData.bIsStarted = (Flags & Flag_Started) != 0;
+			TimerData.bIsPaused = (Flags & Flag_Paused) != 0;
+			TimerData.bLooping = (Flags & Flag_Looping) != 0;
+			TimerData.bIgnoreTimeDilation = (Flags & Flag_IgnoreTimeDilation) != 0;
+			TimerData.Scope = static_cast<EDTTimerScope>(Scope);
+			TimerData.TeamId = TeamId;
+			TimerData.TimeScale = FMath::Max(TimeScale, DynamicTimers::MinTimeScale);
+			TimerData.Duration = DynamicTimers::QuantizeNetTime(Duration);
+			if (!Phases.IsEmpty() && !TimerData.SetPhases(Phases)) continue;
+			TimerData.SetThresholds(Thresholds);
+
+			OutTimers.Add({ MoveTemp(TimerData), FMath::Max(ElapsedTime, 0.0), FMath::Max(StartDelay, 0.0) });
+		}
+
+		return !Reader.IsError();
+	}
+}
+
+// Sets default values for this component's properties
+UDynamicTimersComponent::UDynamicTimersComponent()
+{
+	// Expiry runs off a single engine timer and commits off the end-of-frame delegate, so nothing needs to tick
+	PrimaryComponentTick.bCanEverTick = false;
+	SetIsReplicatedByDefault(true);
+
+	// ...
+}
+
+void UDynamicTimersComponent::PostInitProperties()
+{
+	Super::PostInitProperties();
+
+	ActiveTimers.Owner = this;
+}
+
+void UDynamicTimersComponent::RegisterTimer(FGameplayTag TimerTag, float Duration)
+{
+	DYNAMICTIMERS_SCOPE(UDynamicTimersComponent::RegisterTimer, STAT_DynamicTimers_Mutation);
+
+	if (GetOwnerRole() != ROLE_Authority) return;
+
+	if (TimerIndexByTag.Contains(TimerTag)) return;
+
+	FTimeData NewTimerData;
+	NewTimerData.TimerTag = TimerTag;
+	NewTimerData.Duration = DynamicTimers::QuantizeNetTime(Duration);
+	//NewTimerData.bPersistForJoinInProgress = bShouldPersist;
+	NewTimerData.StartTime = 0.0f;
+	NewTimerData.bIsPaused = false;
+	NewTimerData.ElapsedTimeWhenPaused = 0.0f;
+
+	RegisterTimerData(NewTimerData);
+
+	CommitTimerChanges();
+}
+
+void UDynamicTimersComponent::RegisterLoopingTimer(FGameplayTag TimerTag, float Duration)
+{
+	DYNAMICTIMERS_SCOPE(UDynamicTimersComponent::RegisterLoopingTimer, STAT_DynamicTimers_Mutation);
+
+	if (GetOwnerRole() != ROLE_Authority) return;
+
+	const float NetDuration = DynamicTimers::QuantizeNetTime(Duration);
+	if (TimerIndexByTag.Contains(TimerTag) || NetDuration <= 0.0f) return;
+
+	FTimeData NewTimerData;
+	NewTimerData.TimerTag = TimerTag;
+	NewTimerData.Duration = NetDuration;
+	NewTimerData.bLooping = true;
+
+	RegisterTimerData(NewTimerData);
+
+	CommitTimerChanges();
+}
+
+void UDynamicTimersComponent::RegisterTimerSequence(FGameplayTag TimerTag, const TArray<FDTTimerPhase>& Phases, bool bLoop)
+{
+	DYNAMICTIMERS_SCOPE(UDynamicTimersComponent::RegisterTimerSequence, STAT_DynamicTimers_Mutation);
+
+	if (GetOwnerRole() != ROLE_Authority) return;
+
+	if (TimerIndexByTag.Contains(TimerTag)) return;
+
+	FTimeData NewTimerData;
+	NewTimerData.TimerTag = TimerTag;
+	NewTimerData.bLooping = bLoop;
+	if (!NewTimerData.SetPhases(Phases)) return;
+
+	RegisterTimerData(NewTimerData);
+
+	CommitTimerChanges();
+}
+
+void UDynamicTimersComponent::RegisterScopedTimer(FGameplayTag TimerTag, float Duration, EDTTimerScope Scope, uint8 TeamId, APlayerController* OwningPlayer)
+{
+	DYNAMICTIMERS_SCOPE(UDynamicTimersComponent::RegisterScopedTimer, STAT_DynamicTimers_Mutation);
+
+	if (GetOwnerRole() != ROLE_Authority) return;
+
+	if (TimerIndexByTag.Contains(TimerTag)) return;
+
+	if (Scope == EDTTimerScope::Player && !OwningPlayer)
+	{
+		UE_LOG(LogDynamicTimers, Warning, TEXT("RegisterScopedTimer: %s is player scoped but has no owning player"), *TimerTag.ToString());
+		return;
+	}
+
+	FTimeData NewTimerData;
+	NewTimerData.TimerTag = TimerTag;
+	NewTimerData.Duration = DynamicTimers::QuantizeNetTime(Duration);
+	NewTimerData.Scope = Scope;
+	NewTimerData.TeamId = TeamId;
+	NewTimerData.OwningPlayer = OwningPlayer;
+
+	RegisterTimerData(NewTimerData);
+
+	CommitTimerChanges();
+}
+
+bool UDynamicTimersComponent::RegisterTimerFromDefinition(FGameplayTag TimerTag, APlayerController* OwningPlayer)
+{
+	DYNAMICTIMERS_SCOPE(UDynamicTimersComponent::RegisterTimerFromDefinition, STAT_DynamicTimers_Mutation);
+
+	if (GetOwnerRole() != ROLE_Authority) return false;
+
+	const UDynamicTimerCatalog* Catalog = GetDefault<UDynamicTimersSettings>()->GetTimerCatalog();
+	if (!Catalog || !RegisterDefinedTimer(*Catalog, TimerTag, OwningPlayer)) return false;
+
+	CommitTimerChanges();
+	return true;
+}
+
+int32 UDynamicTimersComponent::RegisterTimersFromDefinitions(const FGameplayTagContainer& TimerTags, APlayerController* OwningPlayer)
+{
+	DYNAMICTIMERS_SCOPE(UDynamicTimersComponent::RegisterTimersFromDefinitions, STAT_DynamicTimers_Mutation);
+
+	if (GetOwnerRole() != ROLE_Authority || TimerTags.IsEmpty()) return 0;
+
+	const UDynamicTimerCatalog* Catalog = GetDefault<UDynamicTimersSettings>()->GetTimerCatalog();
+	if (!Catalog) return 0;
+
+	int32 NumRegistered = 0;
+	for (const FGameplayTag& TimerTag : TimerTags)
+	{
+		NumRegistered += RegisterDefinedTimer(*Catalog, TimerTag, OwningPlayer);
+	}
+
+	if (NumRegistered > 0)
+	{
+		CommitTimerChanges();
+	}
+	return NumRegistered;
+}
+
+bool UDynamicTimersComponent::RegisterDefinedTimer(const UDynamicTimerCatalog& Catalog, const FGameplayTag& TimerTag, APlayerController* OwningPlayer)
+{
+	const FTimeData* Prototype = Catalog.GetPrototype(Catalog.FindDefinitionIndex(TimerTag));
+	if (!Prototype)
+	{
+		UE_LOG(LogDynamicTimers, Warning, TEXT("%s: no definition in %s"), *TimerTag.ToString(), *Catalog.GetName());
+		return false;
+	}
+
+	if (TimerIndexByTag.Contains(TimerTag)) return false;
+	if (Prototype->Scope == EDTTimerScope::Player && !OwningPlayer)
+	{
+		UE_LOG(LogDynamicTimers, Warning, TEXT("%s: the definition is player scoped and needs an owning player"), *TimerTag.ToString());
+		return false;
+	}
+
+	// The catalog already sanitized the prototype, registering is a copy
+	FTimeData NewTimerData = *Prototype;
+	NewTimerData.OwningPlayer = OwningPlayer;
+	NewTimerData.Rate = GetTimerRate(NewTimerData);
+	bTrackTimeDilation |= NewTimerData.bIgnoreTimeDilation;
+
+	RegisterTimerData(NewTimerData);
+	return true;
+}
+
+void UDynamicTimersComponent::SetTimerTimeScale(FGameplayTag TimerTag, float TimeScale)
+{
+	DYNAMICTIMERS_SCOPE(UDynamicTimersComponent::SetTimerTimeScale, STAT_DynamicTimers_Mutation);
+
+	if (GetOwnerRole() != ROLE_Authority) return;
+
+	FTimeData* TimerData = FindTimer(TimerTag);
+	if (!TimerData) return;
+
+	TimerData->TimeScale = FMath::Max(TimeScale, DynamicTimers::MinTimeScale);
+	RebaseTimerRate(*TimerData, GetServerTime());
+
+	CommitTimerChanges();
+}
+
+void UDynamicTimersComponent::SetTimerThresholds(FGameplayTag TimerTag, const TArray<float>& Thresholds)
+{
+	DYNAMICTIMERS_SCOPE(UDynamicTimersComponent::SetTimerThresholds, STAT_DynamicTimers_Mutation);
+
+	if (GetOwnerRole() != ROLE_Authority) return;
+
+	FTimeData* TimerData = FindTimer(TimerTag);
+	if (!TimerData) return;
+
+	TimerData->SetThresholds(Thresholds);
+	// No longer matches its definition, so the thresholds replicate in full
+	TimerData->DefinitionIndex = INDEX_NONE;
+
+	// Thresholds the timer is already past are not announced
+	if (TimerData->bIsStarted)
+	{
+		TimerData->NotifiedThresholds = TimerData->GetPosition(TimerData->GetElapsedTime(GetServerTime())).NumThresholdsReached;
+	}
+	MarkTimerDirty(*TimerData);
+
+	CommitTimerChanges();
+}
+
+void UDynamicTimersComponent::SetTimerIgnoresTimeDilation(FGameplayTag TimerTag, bool bIgnoreTimeDilation)
+{
+	DYNAMICTIMERS_SCOPE(UDynamicTimersComponent::SetTimerIgnoresTimeDilation, STAT_DynamicTimers_Mutation);
+
+	if (GetOwnerRole() != ROLE_Authority) return;
+
+	FTimeData* TimerData = FindTimer(TimerTag);
+	if (!TimerData || TimerData->bIgnoreTimeDilation == bIgnoreTimeDilation) return;
+
+	TimerData->bIgnoreTimeDilation = bIgnoreTimeDilation;
+	if (bIgnoreTimeDilation)
+	{
+		// From here on the end of each frame checks for dilation changes
+		bTrackTimeDilation = true;
+	}
+	RebaseTimerRate(*TimerData, GetServerTime());
+
+	CommitTimerChanges();
+}
+
+void UDynamicTimersComponent::SetPlayerTimerTeam(APlayerController* PlayerController, uint8 TeamId)
+{
+	DYNAMICTIMERS_SCOPE(UDynamicTimersComponent::SetPlayerTimerTeam, STAT_DynamicTimers_Mutation);
+
+	if (GetOwnerRole() != ROLE_Authority || !PlayerController) return;
+
+	// Teams are often assigned from OnPostLogin, before the post login event has given the player its component
+	UDynamicTimersPlayerComponent* PlayerComponent = AddPlayerComponent(PlayerController);
+	if (!PlayerComponent || PlayerComponent->GetTimerTeamId() == TeamId) return;
+
+	PlayerComponent->SetTimerTeamId(TeamId);
+	SyncRelevantTimers(*PlayerComponent);
+}
+
+void UDynamicTimersComponent::StartGlobalTimer(FGameplayTag TimerTag)
+{
+	DYNAMICTIMERS_SCOPE(UDynamicTimersComponent::StartGlobalTimer, STAT_DynamicTimers_Mutation);
+
+	if (GetOwnerRole() != ROLE_Authority) return;
+
+	if (ApplyTimerOperation(TimerTag, EDTTimerOperation::Start, GetServerTime()))
+	{
+		CommitTimerChanges();
+	}
+}
+
+void UDynamicTimersComponent::StartGlobalTimerAt(FGameplayTag TimerTag, double StartServerTime)
+{
+	DYNAMICTIMERS_SCOPE(UDynamicTimersComponent::StartGlobalTimerAt, STAT_DynamicTimers_Mutation);
+
+	if (GetOwnerRole() != ROLE_Authority) return;
+
+	if (ApplyTimerOperation(TimerTag, EDTTimerOperation::Start, FMath::Max(StartServerTime, GetServerTime())))
+	{
+		CommitTimerChanges();
+	}
+}
+
+void UDynamicTimersComponent::RemoveGlobalTimer(FGameplayTag TimerTag)
+{
+	DYNAMICTIMERS_SCOPE(UDynamicTimersComponent::RemoveGlobalTimer, STAT_DynamicTimers_Mutation);
+
+	if (GetOwnerRole() != ROLE_Authority) return;
+
+	if (DestroyTimer(TimerTag))
+	{
+		CommitTimerChanges();
+	}
+}
+
+void UDynamicTimersComponent::PauseGlobalTimer(FGameplayTag TimerTag)
+{
+	DYNAMICTIMERS_SCOPE(UDynamicTimersComponent::PauseGlobalTimer, STAT_DynamicTimers_Mutation);
+
+	if (GetOwnerRole() != ROLE_Authority) return;
+
+	if (ApplyTimerOperation(TimerTag, EDTTimerOperation::Pause, GetServerTime()))
+	{
+		CommitTimerChanges();
+	}
+}
+
+void UDynamicTimersComponent::ResumeGlobalTimer(FGameplayTag TimerTag)
+{
+	DYNAMICTIMERS_SCOPE(UDynamicTimersComponent::ResumeGlobalTimer, STAT_DynamicTimers_Mutation);
+
+	if (GetOwnerRole() != ROLE_Authority) return;
+
+	if (ApplyTimerOperation(TimerTag, EDTTimerOperation::Resume, GetServerTime()))
+	{
+		CommitTimerChanges();
+	}
+}
+
+bool UDynamicTimersComponent::PredictTimerOperation(FGameplayTag TimerTag, EDTTimerOperation Operation)
+{
+	DYNAMICTIMERS_SCOPE(UDynamicTimersComponent::PredictTimerOperation, STAT_DynamicTimers_Mutation);
+
+	if (Operation == EDTTimerOperation::Remove) return false;
+
+	// Listen servers and standalone games have nothing to predict
+	if (GetOwnerRole() == ROLE_Authority)
+	{
+		if (!ApplyTimerOperation(TimerTag, Operation, GetServerTime())) return false;
+
+		CommitTimerChanges();
+		return true;
+	}
+
+	// Only the player's own timers, flagged as such on the wire, come in through UpdateMirroredTimer, which keeps
+	// their rollback state current. Global and team timers would be refused by the server anyway.
+	FTimeData* TimerData = FindMirroredTimer(TimerTag);
+	if (!TimerData || TimerData->Scope != EDTTimerScope::Player) return false;
+
+	// One prediction in flight per timer keeps the rollback state unambiguous
+	if (PendingPredictions.Contains(TimerTag)) return false;
+
+	const APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
+	UDynamicTimersPlayerComponent* PlayerComponent = PlayerController ? PlayerController->FindComponentByClass<UDynamicTimersPlayerComponent>() : nullptr;
+	if (!PlayerComponent) return false;
+
+	const FTimeData AuthoritativeState = *TimerData;
+	const double PredictedTime = GetServerTime();
+	if (!DynamicTimersPrivate::ApplyOperation(*TimerData, Operation, PredictedTime)) return false;
+
+	NextPredictionId = NextPredictionId == TNumericLimits<uint16>::Max() ? 1 : NextPredictionId + 1;
+	PendingPredictions.Add(TimerTag, { NextPredictionId, AuthoritativeState });
+	PlayerComponent->ServerPredictTimerOperation(NextPredictionId, TimerTag, Operation, PredictedTime);
+
+	// Events fire now; the authoritative state only corrects the times, so they do not fire again
+	HandleTimerChanged(*TimerData);
+	RearmTimerSchedules();
+	FlushTimerEvents();
+	return true;
+}
+
+void UDynamicTimersComponent::HandleTimerPredictionRejected(uint16 PredictionId, const FGameplayTag& TimerTag)
+{
+	const FTimerPrediction* Prediction = PendingPredictions.Find(TimerTag);
+	if (!Prediction || Prediction->PredictionId != PredictionId) return;
+
+	const FTimeData AuthoritativeState = Prediction->AuthoritativeState;
+	PendingPredictions.Remove(TimerTag);
+
+	// Back to the latest state the server sent, with the events that undo the prediction
+	if (FTimeData* LocalTimer = FindMirroredTimer(TimerTag))
+	{
+		LocalTimer->CopyStateFrom(AuthoritativeState);
+		HandleTimerChanged(*LocalTimer);
+	}
+
+	OnTimerPredictionRejected.Broadcast(TimerTag);
+	RearmTimerSchedules();
+	FlushTimerEvents();
+}
+
+void UDynamicTimersComponent::RegisterGlobalTimers(const TArray<FBulkTimerRegistrationData>& TimersToRegister)
+{
+	DYNAMICTIMERS_SCOPE(UDynamicTimersComponent::RegisterGlobalTimers, STAT_DynamicTimers_Mutation);
+
+	if (GetOwnerRole() != ROLE_Authority || TimersToRegister.IsEmpty()) return;
+
+	for (const FBulkTimerRegistrationData& RegData : TimersToRegister)
+	{
+		if ((RegData.Duration > 0.0f || !RegData.Phases.IsEmpty()) && !TimerIndexByTag.Contains(RegData.TimerTag))
+		{
+			FTimeData NewTimerData;
+			NewTimerData.TimerTag = RegData.TimerTag;
+			NewTimerData.Duration = DynamicTimers::QuantizeNetTime(RegData.Duration);
+			//NewTimerData.bPersistForJoinInProgress = RegData.bPersistForJoinInProgress;
+			NewTimerData.StartTime = 0.0f;
+			NewTimerData.Scope = RegData.Scope;
+			NewTimerData.TeamId = RegData.TeamId;
+			NewTimerData.OwningPlayer = RegData.OwningPlayer;
+			NewTimerData.bLooping = RegData.bLooping;
+			NewTimerData.TimeScale = FMath::Max(RegData.TimeScale, DynamicTimers::MinTimeScale);
+			NewTimerData.bIgnoreTimeDilation = RegData.bIgnoreTimeDilation;
+			NewTimerData.Rate = GetTimerRate(NewTimerData);
+			bTrackTimeDilation |= NewTimerData.bIgnoreTimeDilation;
+
+			if (NewTimerData.Scope == EDTTimerScope::Player && !NewTimerData.OwningPlayer.IsValid()) continue;
+			if (!RegData.Phases.IsEmpty() && !NewTimerData.SetPhases(RegData.Phases)) continue;
+			NewTimerData.SetThresholds(RegData.Thresholds);
+
+			RegisterTimerData(NewTimerData);
+		}
+	}
+
+	CommitTimerChanges();
+}
+
+void UDynamicTimersComponent::StartGlobalTimers(const FGameplayTagContainer TimerTagsToStart)
+{
+	DYNAMICTIMERS_SCOPE(UDynamicTimersComponent::StartGlobalTimers, STAT_DynamicTimers_Mutation);
+
+	if (GetOwnerRole() != ROLE_Authority || TimerTagsToStart.IsEmpty()) return;
+
+	ApplyTimerOperation(TimerTagsToStart.GetGameplayTagArray(), EDTTimerOperation::Start);
+}
+
+void UDynamicTimersComponent::StartGlobalTimersAt(const FGameplayTagContainer& TimerTags, double StartServerTime)
+{
+	DYNAMICTIMERS_SCOPE(UDynamicTimersComponent::StartGlobalTimersAt, STAT_DynamicTimers_Mutation);
+
+	if (GetOwnerRole() != ROLE_Authority || TimerTags.IsEmpty()) return;
+
+	ApplyTimerOperation(TimerTags.GetGameplayTagArray(), EDTTimerOperation::Start, FMath::Max(StartServerTime, GetServerTime()));
+}
+
+void UDynamicTimersComponent::PauseGlobalTimers(const FGameplayTagContainer TimerTags)
+{
+	DYNAMICTIMERS_SCOPE(UDynamicTimersComponent::PauseGlobalTimers, STAT_DynamicTimers_Mutation);
+
+	if (GetOwnerRole() != ROLE_Authority || TimerTags.IsEmpty()) return;
+
+	ApplyTimerOperation(TimerTags.GetGameplayTagArray(), EDTTimerOperation::Pause);
+}
+
+void UDynamicTimersComponent::ResumeGlobalTimers(const FGameplayTagContainer& TimerTags)
+{
+	DYNAMICTIMERS_SCOPE(UDynamicTimersComponent::ResumeGlobalTimers, STAT_DynamicTimers_Mutation);
+
+	if (GetOwnerRole() != ROLE_Authority || TimerTags.IsEmpty()) return;
+
+	ApplyTimerOperation(TimerTags.GetGameplayTagArray(), EDTTimerOperation::Resume);
+}
+
+int32 UDynamicTimersComponent::ApplyToTimersUnder(FGameplayTag ParentTag, EDTTimerOperation Operation)
+{
+	DYNAMICTIMERS_SCOPE(UDynamicTimersComponent::ApplyToTimersUnder, STAT_DynamicTimers_Mutation);
+
+	if (GetOwnerRole() != ROLE_Authority) return 0;
+
+	const TSet<FGameplayTag>* TimerTags = TimerTagsByAncestor.Find(ParentTag);
+	if (!TimerTags || TimerTags->IsEmpty()) return 0;
+
+	// Removal edits the hierarchy index, so work from a copy of the matches
+	TArray<FGameplayTag, TInlineAllocator<16>> MatchedTimerTags;
+	MatchedTimerTags.Reserve(TimerTags->Num());
+	for (const FGameplayTag& TimerTag : *TimerTags)
+	{
+		MatchedTimerTags.Add(TimerTag);
+	}
+
+	return ApplyTimerOperation(MatchedTimerTags, Operation);
+}
+
+int32 UDynamicTimersComponent::ApplyToTimersMatchingQuery(const FGameplayTagQuery& Query, EDTTimerOperation Operation)
+{
+	DYNAMICTIMERS_SCOPE(UDynamicTimersComponent::ApplyToTimersMatchingQuery, STAT_DynamicTimers_Mutation);
+
+	if (GetOwnerRole() != ROLE_Authority || Query.IsEmpty()) return 0;
+
+	// Arbitrary expressions cannot be answered from the hierarchy index, each timer is tested once.
+	// The container is reused so the scan does not allocate per timer.
+	TArray<FGameplayTag, TInlineAllocator<16>> MatchedTimerTags;
+	FGameplayTagContainer TimerTagContainer;
+	for (const FTimeData& TimerData : ActiveTimers.Items)
+	{
+		TimerTagContainer.Reset();
+		TimerTagContainer.AddTagFast(TimerData.TimerTag);
+		if (Query.Matches(TimerTagContainer))
+		{
+			MatchedTimerTags.Add(TimerData.TimerTag);
+		}
+	}
+
+	return ApplyTimerOperation(MatchedTimerTags, Operation);
+}
+
+void UDynamicTimersComponent::GetTimersUnder(FGameplayTag ParentTag, TArray<FGameplayTag>& OutTimerTags) const
+{
+	OutTimerTags.Reset();
+
+	if (const TSet<FGameplayTag>* TimerTags = TimerTagsByAncestor.Find(ParentTag))
+	{
+		OutTimerTags.Reserve(TimerTags->Num());
+		for (const FGameplayTag& TimerTag : *TimerTags)
+		{
+			OutTimerTags.Add(TimerTag);
+		}
+	}
+}
+
+void UDynamicTimersComponent::BeginTimerBatch()
+{
+	++TimerBatchDepth;
+}
+
+void UDynamicTimersComponent::EndTimerBatch()
+{
+	if (TimerBatchDepth <= 0)
+	{
+		UE_LOG(LogDynamicTimers, Warning, TEXT("%s: EndTimerBatch called without a matching BeginTimerBatch"), *GetNameSafe(GetOwner()));
+		return;
+	}
+
+	if (--TimerBatchDepth == 0 && bHasPendingTimerChanges)
+	{
+		FlushTimerChanges();
+	}
+}
+
+void UDynamicTimersComponent::ExportTimerSnapshot(TArray<uint8>& OutSnapshot) const
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UDynamicTimersComponent::ExportTimerSnapshot);
+
+	using namespace DynamicTimersSnapshot;
+
+	OutSnapshot.Reset();
+	FMemoryWriter Writer(OutSnapshot);
+
+	uint32 SnapshotMagic = Magic;
+	int32 Version = LatestVersion;
+	Writer << SnapshotMagic << Version;
+
+	uint32 NumTimers = 0;
+	for (const FTimeData& TimerData : ActiveTimers.Items)
+	{
+		NumTimers += TimerData.Scope != EDTTimerScope::Player;
+	}
+	Writer.SerializeIntPacked(NumTimers);
+
+	const double ServerTime = GetServerTime();
+	for (const FTimeData& TimerData : ActiveTimers.Items)
+	{
+		if (TimerData.Scope == EDTTimerScope::Player) continue;
+
+		// Elapsed time and start delay rather than a start time, the clock of the restoring world starts over
+		FName TagName = TimerData.TimerTag.GetTagName();
+		uint8 Flags = (TimerData.bIsStarted ? Flag_Started : 0) | (TimerData.bIsPaused ? Flag_Paused : 0)
+			| (TimerData.bLooping ? Flag_Looping : 0) | (TimerData.bIgnoreTimeDilation ? Flag_IgnoreTimeDilation : 0);
+		uint8 Scope = static_cast<uint8>(TimerData.Scope);
+		uint8 TeamId = TimerData.TeamId;
+		float Duration = TimerData.Duration;
+		float TimeScale = TimerData.TimeScale;
+		double ElapsedTime = TimerData.bIsStarted ? TimerData.GetElapsedTime(ServerTime) : 0.0;
+		uint32 NumPhases = TimerData.Phases.Num();
+		Writer << TagName << Flags << Scope << TeamId << Duration << TimeScale << ElapsedTime;
+		Writer.SerializeIntPacked(NumPhases);
+
+		for (const FDTTimerPhase& Phase : TimerData.Phases)
+		{
+			FName PhaseName = Phase.PhaseTag.GetTagName();
+			float PhaseDuration = Phase.Duration;
+			Writer << PhaseName << PhaseDuration;
+		}
+
+		uint32 NumThresholds = TimerData.Thresholds.Num();
+		Writer.SerializeIntPacked(NumThresholds);
+		for (float Threshold : TimerData.Thresholds)
+		{
+			Writer << Threshold;
+		}
+
+		double StartDelay = TimerData.IsWaitingToStart(ServerTime) ? TimerData.StartTime - ServerTime : 0.0;
+		Writer << StartDelay;
+	}
+}
+
+bool UDynamicTimersComponent::RestoreTimerSnapshot(const TArray<uint8>& Snapshot)
+{
+	DYNAMICTIMERS_SCOPE(UDynamicTimersComponent::RestoreTimerSnapshot, STAT_DynamicTimers_Mutation);
+
+	if (GetOwnerRole() != ROLE_Authority) return false;
+
+	// Parsed in full first, so a damaged snapshot leaves the current timers untouched
+	TArray<DynamicTimersSnapshot::FRestoredTimer> RestoredTimers;
+	if (!DynamicTimersSnapshot::Read(Snapshot, RestoredTimers)) return false;
+
+	FDynamicTimersBatchScope Batch(this);
+
+	// A tag had only one timer when the snapshot was written, so a repeated record is ignored
+	TMap<FGameplayTag, int32> RestoredIndexByTag;
+	RestoredIndexByTag.Reserve(RestoredTimers.Num());
+	for (int32 RestoredIndex = 0; RestoredIndex < RestoredTimers.Num(); ++RestoredIndex)
+	{
+		const FGameplayTag& TimerTag = RestoredTimers[RestoredIndex].TimerData.TimerTag;
+		if (!RestoredIndexByTag.Contains(TimerTag))
+		{
+			RestoredIndexByTag.Add(TimerTag, RestoredIndex);
+		}
+	}
+
+	// Only timers the snapshot lacks, or moves to other connections, are removed; they finish here as they do on clients
+	for (int32 Index = ActiveTimers.Items.Num() - 1; Index >= 0; --Index)
+	{
+		const FTimeData& TimerData = ActiveTimers.Items[Index];
+		const int32* RestoredIndex = RestoredIndexByTag.Find(TimerData.TimerTag);
+		if (!RestoredIndex || RestoredTimers[*RestoredIndex].TimerData.Scope != TimerData.Scope
+			|| RestoredTimers[*RestoredIndex].TimerData.TeamId != TimerData.TeamId)
+		{
+			const FGameplayTag TimerTag = TimerData.TimerTag;
+			DestroyTimer(TimerTag);
+		}
+	}
+
+	// Every timer left gets its deadline from the snapshot, so the queue is loaded again in one go
+	ExpiryQueue.Reset();
+
+	const double CurrentTime = GetServerTime();
+	ActiveTimers.Items.Reserve(RestoredTimers.Num());
+	TimerIndexByTag.Reserve(RestoredTimers.Num());
+
+	for (int32 RestoredIndex = 0; RestoredIndex < RestoredTimers.Num(); ++RestoredIndex)
+	{
+		FTimeData& TimerData = RestoredTimers[RestoredIndex].TimerData;
+		if (RestoredIndexByTag[TimerData.TimerTag] != RestoredIndex) continue;
+
+		const DynamicTimersSnapshot::FRestoredTimer& RestoredTimer = RestoredTimers[RestoredIndex];
+		TimerData.Rate = GetTimerRate(TimerData);
+		bTrackTimeDilation |= TimerData.bIgnoreTimeDilation;
+		if (TimerData.bIsPaused)
+		{
+			TimerData.ElapsedTimeWhenPaused = static_cast<float>(DynamicTimers::QuantizeNetTime(RestoredTimer.ElapsedTime));
+		}
+		else if (TimerData.bIsStarted)
+		{
+			TimerData.StartTime = DynamicTimers::QuantizeNetTime(CurrentTime + RestoredTimer.StartDelay - RestoredTimer.ElapsedTime / TimerData.Rate);
+		}
+
+		// A timer that already exists is updated in place, so clients see a change rather than a finish and a new timer
+		FTimeData* RestoredTimerData = FindTimer(TimerData.TimerTag);
+		const bool bExisted = RestoredTimerData != nullptr;
+		if (bExisted)
+		{
+			RestoredTimerData->CopyStateFrom(TimerData);
+		}
+		else
+		{
+			RestoredTimerData = &AddTimer(TimerData);
+		}
+
+		if (RestoredTimerData->IsRunning() && !RestoredTimerData->bLooping)
+		{
+			ExpiryQueue.AddUnordered(RestoredTimerData->TimerTag, RestoredTimerData->GetServerTimeAtElapsed(RestoredTimerData->Duration));
+		}
+
+		if (bExisted)
+		{
+			MarkTimerDirty(*RestoredTimerData);
+		}
+		else
+		{
+			ReplicateTimer(*RestoredTimerData);
+			HandleTimerAdded(*RestoredTimerData);
+		}
+	}
+
+	// Ordered once for the whole set instead of sifting every deadline in
+	ExpiryQueue.Heapify();
+
+	CommitTimerChanges();
+	return true;
+}
+
+double UDynamicTimersComponent::GetServerTime() const
+{
+	const UWorld* World = GetWorld();
+	if (!World) return 0.0;
+
+	if (GetOwnerRole() == ROLE_Authority)
+	{
+		return World->GetTimeSeconds();
+	}
+
+	if (!CachedPlayerComponent.IsValid())
+	{
+		if (const APlayerController* PlayerController = World->GetFirstPlayerController())
+		{
+			CachedPlayerComponent = PlayerController->FindComponentByClass<UDynamicTimersPlayerComponent>();
+		}
+	}
+
+	if (const UDynamicTimersPlayerComponent* PlayerComponent = CachedPlayerComponent.Get())
+	{
+		return PlayerComponent->GetServerTime();
+	}
+
+	const AGameStateBase* GameState = World->GetGameState();
+	return GameState ? GameState->GetServerWorldTimeSeconds() : World->GetTimeSeconds();
+}
+
+bool UDynamicTimersComponent::GetTimerRemainingTime(FGameplayTag TimerTag, float& RemainingTime) const
+{
+	const FTimeData* Timer = FindTimer(TimerTag);
+
+	if (Timer)
+	{
+		RemainingTime = Timer->GetRemainingTime(GetServerTime());
+		return true;
+	}
+	RemainingTime = 0.0f;
+	return false;
+}
+
+bool UDynamicTimersComponent::GetTimerPhase(FGameplayTag TimerTag, FGameplayTag& PhaseTag, int32& PhaseIndex, float& PhaseRemainingTime) const
+{
+	PhaseTag = FGameplayTag();
+	PhaseIndex = INDEX_NONE;
+	PhaseRemainingTime = 0.0f;
+
+	const FTimeData* Timer = FindTimer(TimerTag);
+	if (!Timer || Timer->Phases.IsEmpty()) return false;
+
+	const double ElapsedTime = Timer->GetElapsedTime(GetServerTime());
+	const FDTTimerPosition Position = Timer->GetPosition(ElapsedTime);
+
+	PhaseIndex = Position.PhaseIndex;
+	PhaseTag = Timer->Phases[PhaseIndex].PhaseTag;
+	PhaseRemainingTime = FMath::Max(0.0f, static_cast<float>(Position.BoundaryTime - ElapsedTime));
+	return true;
+}
+
+void UDynamicTimersComponent::GetAllRemainingTimes(TArray<FDTRemainingTime>& OutRemainingTimes) const
+{
+	const double ServerTime = GetServerTime();
+
+	OutRemainingTimes.Reset(GetNumTimers());
+	for (const TArray<FTimeData>* Timers : { &ActiveTimers.Items, &MirroredTimers })
+	{
+		for (const FTimeData& TimerData : *Timers)
+		{
+			FDTRemainingTime& Entry = OutRemainingTimes.AddDefaulted_GetRef();
+			Entry.TimerTag = TimerData.TimerTag;
+			Entry.RemainingTime = TimerData.GetRemainingTime(ServerTime);
+			Entry.bIsRunning = TimerData.IsRunning();
+		}
+	}
+}
+
+void UDynamicTimersComponent::RegisterTimerDisplay(UTimerDisplayWidget* Display)
+{
+	if (!Display) return;
+
+	TimerDisplays.AddUnique(Display);
+	RequestTimerDisplayUpdate();
+}
+
+void UDynamicTimersComponent::UnregisterTimerDisplay(UTimerDisplayWidget* Display)
+{
+	TimerDisplays.RemoveSingleSwap(Display, EAllowShrinking::No);
+}
+
+void UDynamicTimersComponent::RequestTimerDisplayUpdate()
+{
+	if (TimerDisplays.IsEmpty()) return;
+
+	if (UWorld* World = GetWorld())
+	{
+		World->GetTimerManager().SetTimer(DisplayUpdateTimerHandle, this, &UDynamicTimersComponent::UpdateTimerDisplays, UE_KINDA_SMALL_NUMBER, false);
+	}
+}
+
+FDelegateHandle UDynamicTimersComponent::SubscribeToTimer(FGameplayTag TimerTag, bool bIncludeChildren, FDTTimerEventDelegate Delegate)
+{
+	if (!Delegate.IsBound()) return FDelegateHandle();
+
+	TUniquePtr<FTimerSubscribers>& Subscribers = TimerSubscribers.FindOrAdd(TimerTag);
+	if (!Subscribers)
+	{
+		Subscribers = MakeUnique<FTimerSubscribers>();
+	}
+
+	const FDelegateHandle Handle = (bIncludeChildren ? Subscribers->WithChildren : Subscribers->Exact).Add(MoveTemp(Delegate));
+	SubscribedTagByHandle.Add(Handle, TimerTag);
+	return Handle;
+}
+
+void UDynamicTimersComponent::UnsubscribeFromTimer(FDelegateHandle Handle)
+{
+	FGameplayTag TimerTag;
+	if (!SubscribedTagByHandle.RemoveAndCopyValue(Handle, TimerTag)) return;
+
+	if (const TUniquePtr<FTimerSubscribers>* Subscribers = TimerSubscribers.Find(TimerTag))
+	{
+		// Removing during a broadcast is safe, the delegate defers compacting its list
+		if (!(*Subscribers)->Exact.Remove(Handle))
+		{
+			(*Subscribers)->WithChildren.Remove(Handle);
+		}
+	}
+}
+
+void UDynamicTimersComponent::UpdateTimerDisplays()
+{
+	DYNAMICTIMERS_SCOPE(UDynamicTimersComponent::UpdateTimerDisplays, STAT_DynamicTimers_DisplayUpdate);
+
+	const UDynamicTimersSettings* Settings = GetDefault<UDynamicTimersSettings>();
+	const double ServerTime = GetServerTime();
+	float NextUpdateDelay = TNumericLimits<float>::Max();
+
+	// Displays may unregister from inside the update, so the bounds are checked on every step
+	for (int32 Index = TimerDisplays.Num() - 1; Index >= 0; --Index)
+	{
+		if (!TimerDisplays.IsValidIndex(Index)) continue;
+
+		UTimerDisplayWidget* Display = TimerDisplays[Index].Get();
+		if (!Display)
+		{
+			TimerDisplays.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+			continue;
+		}
+
+		const FTimeData* TimerData = FindTimer(Display->GetTimerTag());
+		if (!TimerData) continue;
+
+		const float RemainingTime = TimerData->GetRemainingTime(ServerTime);
+		Display->NativeOnRemainingTimeUpdated(RemainingTime);
+
+		if (TimerData->IsRunning() && RemainingTime > 0.0f)
+		{
+			// Land just past the point where the shown second changes, in server time for timers that run at another rate
+			const float Delay = Settings->bUpdateDisplaysOnWholeSeconds
+				? (RemainingTime - FMath::FloorToFloat(RemainingTime)) / TimerData->Rate + static_cast<float>(ExpiryTolerance)
+				: Settings->GetDisplayUpdateInterval();
+			NextUpdateDelay = FMath::Min(NextUpdateDelay, Delay);
+		}
+	}
+
+	// Paused and idle timers do not change, the next state event requests a new pass
+	FTimerManager& TimerManager = GetWorld()->GetTimerManager();
+	if (NextUpdateDelay < TNumericLimits<float>::Max())
+	{
+		TimerManager.SetTimer(DisplayUpdateTimerHandle, this, &UDynamicTimersComponent::UpdateTimerDisplays, NextUpdateDelay, false);
+	}
+	else
+	{
+		TimerManager.ClearTimer(DisplayUpdateTimerHandle);
+	}
+}
+
+void UDynamicTimersComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+	DOREPLIFETIME_WITH_PARAMS_FAST(UDynamicTimersComponent, ActiveTimers, Params);
+}
+
+void UDynamicTimersComponent::OnExpiryTimerFired()
+{
+	DYNAMICTIMERS_SCOPE(UDynamicTimersComponent::OnExpiryTimerFired, STAT_DynamicTimers_Expiry);
+
+	ExpiryTimer.ArmedDeadline = -1.0;
+
+	// Everything due this frame is removed together: one array update and one flush for the batch
+	ExpiredTimerTags.Reset();
+	ExpiryQueue.PopExpired(GetServerTime() + ExpiryTolerance, ExpiredTimerTags);
+
+	for (const FGameplayTag& TimerTag : ExpiredTimerTags)
+	{
+		DestroyTimer(TimerTag);
+	}
+
+	CommitTimerChanges();
+}
+
+void UDynamicTimersComponent::OnBoundaryTimerFired()
+{
+	DYNAMICTIMERS_SCOPE(UDynamicTimersComponent::OnBoundaryTimerFired, STAT_DynamicTimers_Boundaries);
+
+	BoundaryTimer.ArmedDeadline = -1.0;
+
+	const double ServerTime = GetServerTime() + ExpiryTolerance;
+	ExpiredTimerTags.Reset();
+	BoundaryQueue.PopExpired(ServerTime, ExpiredTimerTags);
+
+	for (const FGameplayTag& TimerTag : ExpiredTimerTags)
+	{
+		if (FTimeData* TimerData = FindTimer(TimerTag))
+		{
+			UpdateNotifiedStart(*TimerData, ServerTime);
+			UpdateTimerPosition(*TimerData, ServerTime);
+		}
+	}
+
+	CommitTimerChanges();
+}
+
+void UDynamicTimersComponent::UpdateTimerPosition(FTimeData& TimerData, double ServerTime)
+{
+	// A scheduled start is a boundary too; phases and loops are worked out once it has passed
+	if (TimerData.IsWaitingToStart(ServerTime))
+	{
+		BoundaryQueue.Schedule(TimerData.TimerTag, TimerData.StartTime);
+		return;
+	}
+
+	if (!TimerData.HasBoundaries())
+	{
+		// Drops the wake-up of a scheduled start that was paused before it came
+		BoundaryQueue.Cancel(TimerData.TimerTag);
+		return;
+	}
+
+	if (!TimerData.bIsStarted)
+	{
+		BoundaryQueue.Cancel(TimerData.TimerTag);
+		return;
+	}
+
+	const FDTTimerPosition Position = TimerData.GetPosition(TimerData.GetElapsedTime(ServerTime));
+
+	// The first position seen is the baseline; resuming a loop rebases it, which is not a new loop either
+	if (TimerData.NotifiedLoop != INDEX_NONE && Position.Loop > TimerData.NotifiedLoop)
+	{
+		QueueTimerEvent(EDTTimerEvent::Looped, TimerData);
+	}
+
+	if (TimerData.NotifiedLoop != INDEX_NONE)
+	{
+		// A new loop counts down through its thresholds again; ones skipped by a long frame are still announced
+		const int32 FirstThreshold = Position.Loop > TimerData.NotifiedLoop ? 0 : TimerData.NotifiedThresholds;
+		for (int32 ThresholdIndex = FirstThreshold; ThresholdIndex < Position.NumThresholdsReached; ++ThresholdIndex)
+		{
+			QueueTimerEvent(EDTTimerEvent::ThresholdReached, TimerData, INDEX_NONE, TimerData.Thresholds[ThresholdIndex]);
+		}
+	}
+	TimerData.NotifiedThresholds = Position.NumThresholdsReached;
+	TimerData.NotifiedLoop = Position.Loop;
+
+	if (Position.PhaseIndex != TimerData.NotifiedPhaseIndex)
+	{
+		QueueTimerEvent(EDTTimerEvent::PhaseChanged, TimerData, Position.PhaseIndex);
+		TimerData.NotifiedPhaseIndex = Position.PhaseIndex;
+	}
+
+	// A sequence that does not loop has nothing left after its last phase, expiry takes it from there
+	if (TimerData.bIsPaused || (!TimerData.bLooping && Position.BoundaryTime >= TimerData.Duration))
+	{
+		BoundaryQueue.Cancel(TimerData.TimerTag);
+	}
+	else
+	{
+		BoundaryQueue.Schedule(TimerData.TimerTag, TimerData.GetServerTimeAtElapsed(Position.BoundaryTime));
+	}
+}
+
+float UDynamicTimersComponent::GetTimerRate(const FTimeData& TimerData) const
+{
+	if (TimerData.bIgnoreTimeDilation)
+	{
+		const AWorldSettings* WorldSettings = GetWorld() ? GetWorld()->GetWorldSettings() : nullptr;
+		const float TimeDilation = WorldSettings ? WorldSettings->GetEffectiveTimeDilation() : 1.0f;
+		return TimerData.TimeScale / FMath::Max(TimeDilation, UE_KINDA_SMALL_NUMBER);
+	}
+	return TimerData.TimeScale;
+}
+
+bool UDynamicTimersComponent::RebaseTimerRate(FTimeData& TimerData, double CurrentTime)
+{
+	const float NewRate = GetTimerRate(TimerData);
+	if (NewRate == TimerData.Rate) return false;
+
+	// Keep the elapsed time continuous: the timer carries on from where it is, only faster or slower.
+	// A timer waiting for its scheduled start keeps the start time and only ends sooner or later.
+	if (TimerData.IsRunning() && !TimerData.IsWaitingToStart(CurrentTime))
+	{
+		const double ElapsedTime = TimerData.GetElapsedTime(CurrentTime);
+		TimerData.StartTime = DynamicTimers::QuantizeNetTime(CurrentTime - ElapsedTime / NewRate);
+	}
+	TimerData.Rate = NewRate;
+
+	if (TimerData.IsRunning())
+	{
+		ScheduleExpiry(TimerData);
+	}
+
+	MarkTimerDirty(TimerData);
+	return true;
+}
+
+void UDynamicTimersComponent::UpdateTimeDilation()
+{
+	const AWorldSettings* WorldSettings = GetWorld()->GetWorldSettings();
+	const float TimeDilation = WorldSettings ? WorldSettings->GetEffectiveTimeDilation() : 1.0f;
+	if (TimeDilation == AppliedTimeDilation) return;
+
+	AppliedTimeDilation = TimeDilation;
+
+	const double CurrentTime = GetServerTime();
+	bool bRebasedAny = false;
+	for (FTimeData& TimerData : ActiveTimers.Items)
+	{
+		if (TimerData.bIgnoreTimeDilation)
+		{
+			bRebasedAny |= RebaseTimerRate(TimerData, CurrentTime);
+		}
+	}
+
+	// Runs from the end-of-frame handler ahead of its pending check, so these go out with this frame's commit
+	if (bRebasedAny)
+	{
+		CommitTimerChanges();
+	}
+}
+
+void UDynamicTimersComponent::ScheduleExpiry(const FTimeData& TimerData)
+{
+	// Looping timers only end when removed
+	if (!TimerData.bLooping)
+	{
+		ExpiryQueue.Schedule(TimerData.TimerTag, TimerData.GetServerTimeAtElapsed(TimerData.Duration));
+	}
+}
+
+void UDynamicTimersComponent::RearmDeadlineTimer(const FDTDeadlineQueue& Queue, FArmedDeadlineTimer& ArmedTimer, void (UDynamicTimersComponent::*Callback)())
+{
+	UWorld* World = GetWorld();
+	if (!World) return;
+
+	FTimerManager& TimerManager = World->GetTimerManager();
+	if (Queue.IsEmpty())
+	{
+		TimerManager.ClearTimer(ArmedTimer.Handle);
+		ArmedTimer.ArmedDeadline = -1.0;
+		return;
+	}
+
+	const double NextDeadline = Queue.PeekDeadline();
+	if (NextDeadline == ArmedTimer.ArmedDeadline && TimerManager.IsTimerActive(ArmedTimer.Handle)) return;
+
+	ArmedTimer.ArmedDeadline = NextDeadline;
+	const float Delay = FMath::Max(static_cast<float>(NextDeadline - GetServerTime()), UE_KINDA_SMALL_NUMBER);
+	TimerManager.SetTimer(ArmedTimer.Handle, this, Callback, Delay, false);
+}
+
+void UDynamicTimersComponent::RearmTimerSchedules()
+{
+	RearmDeadlineTimer(ExpiryQueue, ExpiryTimer, &UDynamicTimersComponent::OnExpiryTimerFired);
+	RearmDeadlineTimer(BoundaryQueue, BoundaryTimer, &UDynamicTimersComponent::OnBoundaryTimerFired);
+}
+
+FTimeData* UDynamicTimersComponent::FindTimer(const FGameplayTag& TimerTag)
+{
+	return const_cast<FTimeData*>(static_cast<const UDynamicTimersComponent*>(this)->FindTimer(TimerTag));
+}
+
+const FTimeData* UDynamicTimersComponent::FindTimer(const FGameplayTag& TimerTag) const
+{
+	if (const int32* Index = TimerIndexByTag.Find(TimerTag))
+	{
+		return &ActiveTimers.Items[*Index];
+	}
 
+	const int32* MirroredIndex = MirroredTimerIndexByTag.Find(TimerTag);
+	return MirroredIndex ? &MirroredTimers[*MirroredIndex] : nullptr;
+}
 
-// Sets default values for this component's properties
-UDynamicTimersComponent::UDynamicTimersComponent()
+FTimeData* UDynamicTimersComponent::FindMirroredTimer(const FGameplayTag& TimerTag)
 {
-	// Set this component to be initialized when the game starts, and to be ticked every frame.  You can turn these features
-	// off to improve performance if you don't need them.
-	PrimaryComponentTick.bCanEverTick = true;
-	SetIsReplicatedByDefault(true);
+	const int32* Index = MirroredTimerIndexByTag.Find(TimerTag);
+	return Index ? &MirroredTimers[*Index] : nullptr;
+}
 
-	// ...
+FTimeData& UDynamicTimersComponent::AddTimer(const FTimeData& NewTimerData)
+{
+	const int32 NewIndex = ActiveTimers.Items.Add(NewTimerData);
+	TimerIndexByTag.Add(NewTimerData.TimerTag, NewIndex);
+	AddToTimerHierarchy(NewTimerData.TimerTag);
+	return ActiveTimers.Items[NewIndex];
 }
 
-void UDynamicTimersComponent::RegisterTimer(FGameplayTag TimerTag, float Duration)
+bool UDynamicTimersComponent::RemoveTimer(const FGameplayTag& TimerTag)
 {
-	if (GetOwnerRole() != ROLE_Authority) return;
+	int32 Index = INDEX_NONE;
+	if (!TimerIndexByTag.RemoveAndCopyValue(TimerTag, Index))
+	{
+		return false;
+	}
 
-	const bool bAlreadyExists = ActiveTimers.ContainsByPredicate([&](const FTimeData& TimerData) {
-		return TimerData.TimerTag.MatchesTagExact(TimerTag);
-	});
+	ExpiryQueue.Cancel(TimerTag);
+	RemoveFromTimerHierarchy(TimerTag);
 
-	if (bAlreadyExists) return;
+	// Swap the last timer into the freed slot so only one index entry needs patching
+	ActiveTimers.Items.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	if (ActiveTimers.Items.IsValidIndex(Index))
+	{
+		TimerIndexByTag.Add(ActiveTimers.Items[Index].TimerTag, Index);
+	}
+	return true;
+}
 
-	FTimeData NewTimerData;
-	NewTimerData.TimerTag = TimerTag;
-	NewTimerData.Duration = Duration;
-	//NewTimerData.bPersistForJoinInProgress = bShouldPersist;
-	NewTimerData.StartTime = 0.0f;
-	NewTimerData.bIsPaused = false;
-	NewTimerData.ElapsedTimeWhenPaused = 0.0f;
+void UDynamicTimersComponent::RebuildTimerIndex()
+{
+	TimerIndexByTag.Reset();
+	TimerIndexByTag.Reserve(ActiveTimers.Items.Num());
+	for (TPair<FGameplayTag, TSet<FGameplayTag>>& Descendants : TimerTagsByAncestor)
+	{
+		Descendants.Value.Reset();
+	}
 
-	ActiveTimers.Add(NewTimerData);
+	for (int32 Index = 0; Index < ActiveTimers.Items.Num(); ++Index)
+	{
+		TimerIndexByTag.Add(ActiveTimers.Items[Index].TimerTag, Index);
+		AddToTimerHierarchy(ActiveTimers.Items[Index].TimerTag);
+	}
 
-	OnRep_ActiveTimers();
+	// Mirrored timers keep their own index up to date, they only need to be back in the hierarchy
+	for (const FTimeData& TimerData : MirroredTimers)
+	{
+		AddToTimerHierarchy(TimerData.TimerTag);
+	}
+	bTimerIndexDirty = false;
 }
 
-void UDynamicTimersComponent::StartGlobalTimer(FGameplayTag TimerTag)
+void UDynamicTimersComponent::AddToTimerHierarchy(const FGameplayTag& TimerTag)
 {
-	if (GetOwnerRole() != ROLE_Authority) return;
+	for (FGameplayTag Tag = TimerTag; Tag.IsValid(); Tag = Tag.RequestDirectParent())
+	{
+		TimerTagsByAncestor.FindOrAdd(Tag).Add(TimerTag);
+	}
+}
 
-	FTimeData* TimerData = ActiveTimers.FindByPredicate([&](const FTimeData& Data) {
-		return Data.TimerTag.MatchesTagExact(TimerTag);
-	});
+void UDynamicTimersComponent::RemoveFromTimerHierarchy(const FGameplayTag& TimerTag)
+{
+	// Emptied sets are kept, the same branches tend to be reused by the next round of timers
+	for (FGameplayTag Tag = TimerTag; Tag.IsValid(); Tag = Tag.RequestDirectParent())
+	{
+		if (TSet<FGameplayTag>* Descendants = TimerTagsByAncestor.Find(Tag))
+		{
+			Descendants->Remove(TimerTag);
+		}
+	}
+}
+
+void UDynamicTimersComponent::RegisterTimerData(const FTimeData& NewTimerData)
+{
+	FTimeData& AddedTimer = AddTimer(NewTimerData);
+	ReplicateTimer(AddedTimer);
+	HandleTimerAdded(AddedTimer);
+}
+
+bool UDynamicTimersComponent::DestroyTimer(const FGameplayTag& TimerTag)
+{
+	const FTimeData* TimerData = FindTimer(TimerTag);
+	if (!TimerData) return false;
+
+	HandleTimerRemoved(*TimerData);
+	ReplicateTimerRemoval(*TimerData);
+	RemoveTimer(TimerTag);
+	return true;
+}
 
-	if (TimerData && TimerData->StartTime == 0.0f)
+bool UDynamicTimersComponent::ApplyTimerOperation(const FGameplayTag& TimerTag, EDTTimerOperation Operation, double CurrentTime)
+{
+	if (Operation == EDTTimerOperation::Remove)
 	{
-		TimerData->StartTime = GetWorld()->GetTimeSeconds();
+		return DestroyTimer(TimerTag);
+	}
 
-		FTimerHandle ServerTimerHandle;
-		FTimerDelegate TimerDelegate = FTimerDelegate::CreateUObject(this, &UDynamicTimersComponent::OnServerTimerFinished, TimerTag);
-		GetWorld()->GetTimerManager().SetTimer(ServerTimerHandle, TimerDelegate, TimerData->Duration, false);
+	FTimeData* TimerData = FindTimer(TimerTag);
+	if (!TimerData || !DynamicTimersPrivate::ApplyOperation(*TimerData, Operation, CurrentTime)) return false;
 
-		OnRep_ActiveTimers();
+	if (TimerData->IsRunning())
+	{
+		ScheduleExpiry(*TimerData);
+	}
+	else
+	{
+		ExpiryQueue.Cancel(TimerTag);
 	}
+
+	MarkTimerDirty(*TimerData);
+	return true;
 }
 
-void UDynamicTimersComponent::RemoveGlobalTimer(FGameplayTag TimerTag)
+bool UDynamicTimersComponent::ApplyPredictedTimerOperation(const APlayerController* PlayerController, uint16 PredictionId, const FGameplayTag& TimerTag, EDTTimerOperation Operation, double PredictedTime)
 {
-	if (GetOwnerRole() != ROLE_Authority) return;
+	DYNAMICTIMERS_SCOPE(UDynamicTimersComponent::ApplyPredictedTimerOperation, STAT_DynamicTimers_Mutation);
 
-	const int32 RemovedCount = ActiveTimers.RemoveAll([&](const FTimeData& TimerData) {
-		return TimerData.TimerTag.MatchesTagExact(TimerTag);
-	});
+	// Clients only get to drive their own timers, and only forwards: removal stays with the server
+	FTimeData* TimerData = FindTimer(TimerTag);
+	if (!TimerData || Operation == EDTTimerOperation::Remove || TimerData->Scope != EDTTimerScope::Player
+		|| TimerData->OwningPlayer.Get() != PlayerController)
+	{
+		return false;
+	}
+
+	// The client's clock estimate is trusted within a small window, so an honest client's countdown barely moves
+	const double ServerTime = GetServerTime();
+	const double OperationTime = FMath::Clamp(PredictedTime, ServerTime - GetDefault<UDynamicTimersSettings>()->MaxPredictionRewind, ServerTime);
 
-	if (RemovedCount > 0)
+	const uint16 PreviousPredictionId = TimerData->PredictionId;
+	TimerData->PredictionId = PredictionId;
+	if (!ApplyTimerOperation(TimerTag, Operation, OperationTime))
 	{
-		OnRep_ActiveTimers();
+		TimerData->PredictionId = PreviousPredictionId;
+		return false;
 	}
+
+	CommitTimerChanges();
+	return true;
 }
 
-void UDynamicTimersComponent::PauseGlobalTimer(FGameplayTag TimerTag)
+int32 UDynamicTimersComponent::ApplyTimerOperation(TConstArrayView<FGameplayTag> TimerTags, EDTTimerOperation Operation)
 {
-	if (GetOwnerRole() != ROLE_Authority) return;
+	return ApplyTimerOperation(TimerTags, Operation, GetServerTime());
+}
 
-	FTimeData* TimerData = ActiveTimers.FindByPredicate([&](const FTimeData& Data) {
-		return Data.TimerTag.MatchesTagExact(TimerTag);
-	});
+int32 UDynamicTimersComponent::ApplyTimerOperation(TConstArrayView<FGameplayTag> TimerTags, EDTTimerOperation Operation, double CurrentTime)
+{
+	DYNAMICTIMERS_SCOPE(UDynamicTimersComponent::ApplyTimerOperation, STAT_DynamicTimers_Mutation);
+
+	if (TimerTags.IsEmpty()) return 0;
+
+	// Every match shares one timestamp and lands in the same commit
+	FDynamicTimersBatchScope Batch(this);
 
-	if (TimerData && TimerData->StartTime > 0.0f && !TimerData->bIsPaused)
+	int32 NumApplied = 0;
+	for (const FGameplayTag& TimerTag : TimerTags)
 	{
-		TimerData->bIsPaused = true;
-		TimerData->ElapsedTimeWhenPaused = GetWorld()->GetTimeSeconds() - TimerData->StartTime;
+		if (ApplyTimerOperation(TimerTag, Operation, CurrentTime))
+		{
+			++NumApplied;
+		}
+	}
 
-		OnRep_ActiveTimers();
+	if (NumApplied > 0)
+	{
+		CommitTimerChanges();
 	}
+	return NumApplied;
 }
 
-void UDynamicTimersComponent::ResumeGlobalTimer(FGameplayTag TimerTag)
+void UDynamicTimersComponent::MarkTimerDirty(FTimeData& TimerData)
 {
-	if (GetOwnerRole() != ROLE_Authority) return;
+	ReplicateTimer(TimerData);
+	HandleTimerChanged(TimerData);
+}
+
+void UDynamicTimersComponent::ReplicateTimer(FTimeData& TimerData)
+{
+	if (TimerData.Scope == EDTTimerScope::Global)
+	{
+		ActiveTimers.MarkItemDirty(TimerData);
+		bTimerPropertyDirty = true;
+		return;
+	}
 
-	FTimeData* TimerData = ActiveTimers.FindByPredicate([&](const FTimeData& Data) {
-		return Data.TimerTag.MatchesTagExact(TimerTag);
+	// Scoped timers never enter the game state's stream, they are copied to the connections they concern
+	ForEachRelevantPlayerComponent(TimerData, [&TimerData](UDynamicTimersPlayerComponent& PlayerComponent)
+	{
+		PlayerComponent.UpsertRelevantTimer(TimerData);
 	});
+}
+
+void UDynamicTimersComponent::ReplicateTimerRemoval(const FTimeData& TimerData)
+{
+	if (TimerData.Scope == EDTTimerScope::Global)
+	{
+		bTimerArrayDirty = true;
+		bTimerPropertyDirty = true;
+		return;
+	}
 
-	if (TimerData && TimerData->bIsPaused)
+	ForEachRelevantPlayerComponent(TimerData, [&TimerData](UDynamicTimersPlayerComponent& PlayerComponent)
 	{
-		TimerData->bIsPaused = false;
-		TimerData->StartTime = GetWorld()->GetTimeSeconds() - TimerData->ElapsedTimeWhenPaused;
+		PlayerComponent.RemoveRelevantTimer(TimerData.TimerTag);
+	});
+}
 
-		const float RemainingDuration = TimerData->Duration - TimerData->ElapsedTimeWhenPaused;
+void UDynamicTimersComponent::ForEachRelevantPlayerComponent(const FTimeData& TimerData, TFunctionRef<void(UDynamicTimersPlayerComponent&)> Callback)
+{
+	if (TimerData.Scope == EDTTimerScope::Player)
+	{
+		if (const APlayerController* OwningPlayer = TimerData.OwningPlayer.Get())
+		{
+			if (UDynamicTimersPlayerComponent* PlayerComponent = OwningPlayer->FindComponentByClass<UDynamicTimersPlayerComponent>())
+			{
+				Callback(*PlayerComponent);
+			}
+		}
+		return;
+	}
 
-		FTimerHandle ServerTimerHandle;
-		FTimerDelegate TimerDelegate = FTimerDelegate::CreateUObject(this, &UDynamicTimersComponent::OnServerTimerFinished, TimerTag);
-		GetWorld()->GetTimerManager().SetTimer(ServerTimerHandle, TimerDelegate, RemainingDuration, false);
+	if (TimerData.Scope == EDTTimerScope::Team && TimerData.TeamId != DynamicTimers::NoTeam)
+	{
+		for (int32 Index = PlayerComponents.Num() - 1; Index >= 0; --Index)
+		{
+			UDynamicTimersPlayerComponent* PlayerComponent = PlayerComponents[Index].Get();
+			if (!PlayerComponent)
+			{
+				PlayerComponents.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+				continue;
+			}
 
-		OnRep_ActiveTimers();
+			if (PlayerComponent->GetTimerTeamId() == TimerData.TeamId)
+			{
+				Callback(*PlayerComponent);
+			}
+		}
 	}
 }
 
-void UDynamicTimersComponent::RegisterGlobalTimers(const TArray<FBulkTimerRegistrationData>& TimersToRegister)
+void UDynamicTimersComponent::AddMirroredTimer(const FTimeData& TimerData)
 {
-	if (GetOwnerRole() != ROLE_Authority || TimersToRegister.IsEmpty()) return; 
-
-	bool bDidChange = false;
-	for (const FBulkTimerRegistrationData& RegData : TimersToRegister)
+	if (MirroredTimerIndexByTag.Contains(TimerData.TimerTag))
 	{
-		const bool bAlreadyExists = ActiveTimers.ContainsByPredicate([&](const FTimeData& Timer)
-		{
-			return Timer.TimerTag.MatchesTagExact(RegData.TimerTag);
-		});
+		UpdateMirroredTimer(TimerData);
+		return;
+	}
 
-		if (!bAlreadyExists && RegData.Duration > 0.0f)
-		{
-			FTimeData NewTimerData;
-			NewTimerData.TimerTag = RegData.TimerTag;
-			NewTimerData.Duration = RegData.Duration;
-			//NewTimerData.bPersistForJoinInProgress = RegData.bPersistForJoinInProgress;
-			NewTimerData.StartTime = 0.0f;
+	const int32 NewIndex = MirroredTimers.Add(TimerData);
+	MirroredTimerIndexByTag.Add(TimerData.TimerTag, NewIndex);
+	AddToTimerHierarchy(TimerData.TimerTag);
+
+	FTimeData& AddedTimer = MirroredTimers[NewIndex];
+	AddedTimer.bNotifiedStarted = false;
+	AddedTimer.bNotifiedPaused = false;
+	AddedTimer.NotifiedPhaseIndex = INDEX_NONE;
+	AddedTimer.NotifiedLoop = INDEX_NONE;
+	HandleTimerAdded(AddedTimer);
+}
 
-			ActiveTimers.Add(NewTimerData);
-			bDidChange = true;
+void UDynamicTimersComponent::UpdateMirroredTimer(const FTimeData& TimerData)
+{
+	if (FTimerPrediction* Prediction = PendingPredictions.Find(TimerData.TimerTag))
+	{
+		// State from before the server applied the prediction is only kept for a rollback
+		if (!DynamicTimers::IsPredictionAtOrAfter(TimerData.PredictionId, Prediction->PredictionId))
+		{
+			Prediction->AuthoritativeState = TimerData;
+			return;
 		}
+		PendingPredictions.Remove(TimerData.TimerTag);
 	}
 
-	if (bDidChange)
+	if (FTimeData* LocalTimer = FindMirroredTimer(TimerData.TimerTag))
 	{
-		OnRep_ActiveTimers();
+		LocalTimer->CopyStateFrom(TimerData);
+		HandleTimerChanged(*LocalTimer);
 	}
 }
 
-void UDynamicTimersComponent::StartGlobalTimers(const FGameplayTagContainer TimerTagsToStart)
+void UDynamicTimersComponent::RemoveMirroredTimer(const FGameplayTag& TimerTag)
 {
-	if (GetOwnerRole() != ROLE_Authority || TimerTagsToStart.IsEmpty()) return;
+	PendingPredictions.Remove(TimerTag);
 
-	bool bDidChange = false;
-	const float CurrentTime = GetWorld()->GetTimeSeconds();
+	int32 Index = INDEX_NONE;
+	if (!MirroredTimerIndexByTag.RemoveAndCopyValue(TimerTag, Index)) return;
 
-	for (const FGameplayTag& Tag : TimerTagsToStart.GetGameplayTagArray())
+	HandleTimerRemoved(MirroredTimers[Index]);
+	RemoveFromTimerHierarchy(TimerTag);
+
+	// Local storage, so swapping the last mirror into the freed slot only needs its index entry patched
+	MirroredTimers.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	if (MirroredTimers.IsValidIndex(Index))
 	{
-		FTimeData* TimerData = ActiveTimers.FindByPredicate([&](const FTimeData& Timer)
-		{
-			return Timer.TimerTag.MatchesTagExact(Tag);
-		});
+		MirroredTimerIndexByTag.Add(MirroredTimers[Index].TimerTag, Index);
+	}
+}
 
-		if (TimerData && TimerData->StartTime <= 0.0f)
-		{
-			TimerData->StartTime = CurrentTime;
+void UDynamicTimersComponent::CommitTimerChanges()
+{
+	bHasPendingTimerChanges = true;
 
-			FTimerHandle ServerTimerHandle;
-			FTimerDelegate TimerDelegate = FTimerDelegate::CreateUObject(this, &UDynamicTimersComponent::OnServerTimerFinished, Tag);
-			GetWorld()->GetTimerManager().SetTimer(ServerTimerHandle, TimerDelegate, TimerData->Duration, false);
-			bDidChange = true;
-		}
+	// Bound once on first use; the end-of-frame handler is a no-op while nothing is pending
+	if (!PostActorTickHandle.IsValid())
+	{
+		PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UDynamicTimersComponent::HandleWorldPostActorTick);
+	}
+}
+
+void UDynamicTimersComponent::FlushTimerChanges()
+{
+	DYNAMICTIMERS_SCOPE(UDynamicTimersComponent::FlushTimerChanges, STAT_DynamicTimers_Commit);
+
+	bHasPendingTimerChanges = false;
+
+	if (bTimerArrayDirty)
+	{
+		ActiveTimers.MarkArrayDirty();
+		bTimerArrayDirty = false;
 	}
-	if (bDidChange)
+
+	// One push-model dirty mark per commit, however many timers changed
+	if (bTimerPropertyDirty)
 	{
-		OnRep_ActiveTimers();
+		MARK_PROPERTY_DIRTY_FROM_NAME(UDynamicTimersComponent, ActiveTimers, this);
+		bTimerPropertyDirty = false;
+
+		if (bUseNetDormancy)
+		{
+			if (AActor* Owner = GetOwner())
+			{
+				Owner->FlushNetDormancy();
+			}
+		}
 	}
+
+	RearmTimerSchedules();
+	FlushTimerEvents();
 }
 
-void UDynamicTimersComponent::PauseGlobalTimers(const FGameplayTagContainer TimerTags)
+void UDynamicTimersComponent::HandleWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
 {
-	if (GetOwnerRole() != ROLE_Authority || TimerTags.IsEmpty()) return;
+	if (World != GetWorld()) return;
 
-	bool bDidChange = false;
-	const float CurrentTime = GetWorld()->GetTimeSeconds();
+	// A dilation change is one rebase and one replicated update per affected timer, never a per-frame update
+	if (bTrackTimeDilation)
+	{
+		UpdateTimeDilation();
+	}
 
-	for (const FGameplayTag& Tag : TimerTags.GetGameplayTagArray())
+	if (bPublishReadSnapshot)
 	{
-		FTimeData* TimerData = ActiveTimers.FindByPredicate([&](const FTimeData& Timer)
+		// Worker threads extrapolate the server time from here until the next frame
+		const AWorldSettings* WorldSettings = World->GetWorldSettings();
+		const double ClockRate = World->IsPaused() || !WorldSettings ? 0.0 : WorldSettings->GetEffectiveTimeDilation();
+		ReadSnapshot.UpdateClock(GetServerTime(), ClockRate);
+
+		if (bReadSnapshotDirty && !bHasPendingTimerChanges)
 		{
-			return Timer.TimerTag.MatchesTagExact(Tag);
-		});
+			PublishReadSnapshot();
+		}
+	}
+
+	if (!bHasPendingTimerChanges) return;
 
-		TimerData->bIsPaused = true;
-		TimerData->ElapsedTimeWhenPaused = CurrentTime - TimerData->StartTime;
-		bDidChange = true;
+	// A Blueprint batch is not allowed to span frames, commit whatever it has collected
+	if (TimerBatchDepth > 0)
+	{
+		UE_LOG(LogDynamicTimers, Warning, TEXT("%s: timer batch left open at end of frame, committing it"), *GetNameSafe(GetOwner()));
+		TimerBatchDepth = 0;
 	}
-	if (bDidChange)
+
+	FlushTimerChanges();
+}
+
+void UDynamicTimersComponent::HandleTimerAdded(FTimeData& TimerData)
+{
+	// Replicated adds land at arbitrary slots, the index is rebuilt once the whole update is in
+	if (GetOwnerRole() != ROLE_Authority)
 	{
-		OnRep_ActiveTimers();
+		bTimerIndexDirty = true;
 	}
+
+	bReadSnapshotDirty = true;
+	QueueTimerEvent(EDTTimerEvent::Registered, TimerData);
+
+	// A late joiner can receive a timer that is already running or paused
+	HandleTimerChanged(TimerData);
 }
 
-void UDynamicTimersComponent::ResumeGlobalTimers(const FGameplayTagContainer& TimerTags)
+void UDynamicTimersComponent::HandleTimerChanged(FTimeData& TimerData)
 {
-	if (GetOwnerRole() != ROLE_Authority || TimerTags.IsEmpty()) return;
+	bReadSnapshotDirty = true;
 
-	bool bDidChange = false;
-	const float CurrentTime = GetWorld()->GetTimeSeconds();
+	const double ServerTime = GetServerTime();
+	UpdateNotifiedStart(TimerData, ServerTime);
 
-	for (const FGameplayTag& Tag : TimerTags.GetGameplayTagArray())
+	if (TimerData.bIsPaused != TimerData.bNotifiedPaused)
 	{
-		FTimeData* TimerData = ActiveTimers.FindByPredicate([&](const FTimeData& Timer)
-		{
-			return Timer.TimerTag.MatchesTagExact(Tag);
-		});
+		QueueTimerEvent(TimerData.bIsPaused ? EDTTimerEvent::Paused : EDTTimerEvent::Resumed, TimerData);
+		NumPausedTimers += TimerData.bIsPaused ? 1 : -1;
+		TimerData.bNotifiedPaused = TimerData.bIsPaused;
+	}
 
-		if (TimerData && TimerData->bIsPaused)
-		{
-			TimerData->bIsPaused = false;
-			TimerData->StartTime = CurrentTime - TimerData->ElapsedTimeWhenPaused;
+	UpdateTimerPosition(TimerData, ServerTime);
+}
 
-			const float RemainingDuration = TimerData->Duration - TimerData->ElapsedTimeWhenPaused;
+void UDynamicTimersComponent::UpdateNotifiedStart(FTimeData& TimerData, double ServerTime)
+{
+	const bool bHasStarted = TimerData.bIsStarted && !TimerData.IsWaitingToStart(ServerTime);
+	if (bHasStarted && !TimerData.bNotifiedStarted)
+	{
+		QueueTimerEvent(EDTTimerEvent::Started, TimerData);
+	}
+	NumStartedTimers += static_cast<int32>(bHasStarted) - static_cast<int32>(TimerData.bNotifiedStarted);
+	TimerData.bNotifiedStarted = bHasStarted;
+}
 
-			FTimerHandle ServerTimerHandle;
-			FTimerDelegate TimerDelegate = FTimerDelegate::CreateUObject(this, &UDynamicTimersComponent::OnServerTimerFinished, Tag);
-			GetWorld()->GetTimerManager().SetTimer(ServerTimerHandle, TimerDelegate, RemainingDuration, false);
-			bDidChange = true;
-		}
+void UDynamicTimersComponent::HandleTimerRemoved(const FTimeData& TimerData)
+{
+	if (GetOwnerRole() != ROLE_Authority)
+	{
+		bTimerIndexDirty = true;
 	}
-	if (bDidChange)
+
+	bReadSnapshotDirty = true;
+	BoundaryQueue.Cancel(TimerData.TimerTag);
+	NumStartedTimers -= TimerData.bNotifiedStarted;
+	NumPausedTimers -= TimerData.bNotifiedPaused;
+	QueueTimerEvent(EDTTimerEvent::Finished, TimerData);
+}
+
+void UDynamicTimersComponent::HandleTimersReceived()
+{
+	if (bTimerIndexDirty)
 	{
-		OnRep_ActiveTimers();
+		RebuildTimerIndex();
 	}
+
+	RearmTimerSchedules();
+	FlushTimerEvents();
 }
 
-bool UDynamicTimersComponent::GetTimerRemainingTime(FGameplayTag TimerTag, float& RemainingTime) const
+void UDynamicTimersComponent::QueueTimerEvent(EDTTimerEvent Event, const FTimeData& TimerData, int32 PhaseIndex, float Threshold)
 {
-	const FTimeData* Timer = ActiveTimers.FindByPredicate([&](const FTimeData& Data) {
-		return Data.TimerTag.MatchesTagExact(TimerTag);
-	});
+	const FGameplayTag PhaseTag = TimerData.Phases.IsValidIndex(PhaseIndex) ? TimerData.Phases[PhaseIndex].PhaseTag : FGameplayTag();
+	PendingTimerEvents.Add({ Event, TimerData.TimerTag, TimerData.Duration, PhaseTag, PhaseIndex, Threshold });
+}
 
-	if (Timer)
+void UDynamicTimersComponent::FlushTimerEvents()
+{
+	// Listeners may mutate timers from inside a broadcast; those events queue behind these and the outer flush picks them up
+	if (bIsFlushingTimerEvents) return;
+	TGuardValue<bool> FlushGuard(bIsFlushingTimerEvents, true);
+
+	for (int32 EventIndex = 0; EventIndex < PendingTimerEvents.Num(); ++EventIndex)
 	{
-		if (Timer->StartTime == 0.0f)
+		const FDTTimerEventData PendingEvent = PendingTimerEvents[EventIndex];
+		switch (PendingEvent.Event)
 		{
-			RemainingTime = Timer->Duration;
-			return true;
+		case EDTTimerEvent::Registered:
+			OnTimerRegistered.Broadcast(PendingEvent.TimerTag, PendingEvent.Duration);
+			break;
+		case EDTTimerEvent::Started:
+			OnTimerStarted.Broadcast(PendingEvent.TimerTag, PendingEvent.Duration);
+			break;
+		case EDTTimerEvent::Paused:
+			OnTimerPaused.Broadcast(PendingEvent.TimerTag);
+			break;
+		case EDTTimerEvent::Resumed:
+			OnTimerResumed.Broadcast(PendingEvent.TimerTag);
+			break;
+		case EDTTimerEvent::Finished:
+			OnTimerFinished.Broadcast(PendingEvent.TimerTag);
+			break;
+		case EDTTimerEvent::PhaseChanged:
+			OnTimerPhaseChanged.Broadcast(PendingEvent.TimerTag, PendingEvent.PhaseTag, PendingEvent.PhaseIndex);
+			break;
+		case EDTTimerEvent::Looped:
+			OnTimerLooped.Broadcast(PendingEvent.TimerTag);
+			break;
+		case EDTTimerEvent::ThresholdReached:
+			OnTimerThresholdReached.Broadcast(PendingEvent.TimerTag, PendingEvent.Threshold);
+			break;
 		}
-		
-		if (Timer->bIsPaused)
+
+		if (!TimerSubscribers.IsEmpty())
 		{
-			RemainingTime = FMath::Max(0.0f, Timer->Duration - Timer->ElapsedTimeWhenPaused);
-			return true;
+			NotifyTimerSubscribers(PendingEvent);
 		}
+	}
 
-		const float ElapsedTime = GetWorld()->GetTimeSeconds() - Timer->StartTime;
-		RemainingTime = FMath::Max(0.0f, Timer->Duration - ElapsedTime);
-		return true;
+	if (!PendingTimerEvents.IsEmpty())
+	{
+		INC_DWORD_STAT_BY(STAT_DynamicTimers_Broadcasts, PendingTimerEvents.Num());
+		PendingTimerEvents.Reset();
+		RequestTimerDisplayUpdate();
 	}
-	RemainingTime = 0.0f;
-	return false;
+
+	ReportTimerStats(GetNumTimers(), NumPausedTimers, GetNumTimers() - NumStartedTimers);
+
+	if (bPublishReadSnapshot && bReadSnapshotDirty)
+	{
+		PublishReadSnapshot();
+	}
+}
+
+void UDynamicTimersComponent::PublishReadSnapshot()
+{
+	DYNAMICTIMERS_SCOPE(UDynamicTimersComponent::PublishReadSnapshot, STAT_DynamicTimers_PublishSnapshot);
+
+	bReadSnapshotDirty = !ReadSnapshot.Publish(ActiveTimers.Items, MirroredTimers);
 }
 
-void UDynamicTimersComponent::OnRep_ActiveTimers()
+void UDynamicTimersComponent::NotifyTimerSubscribers(const FDTTimerEventData& EventData) const
 {
-	for (const FTimeData& NewTimer : ActiveTimers)
+	// Map slots can move when a callback subscribes, the boxed subscribers cannot
+	if (const TUniquePtr<FTimerSubscribers>* Found = TimerSubscribers.Find(EventData.TimerTag))
 	{
-		const FTimeData* OldTimer = Old_ActiveTimers.FindByPredicate([&](const FTimeData& Data) {
-			return Data.TimerTag.MatchesTagExact(NewTimer.TimerTag);
-		});
+		const FTimerSubscribers* Subscribers = Found->Get();
+		Subscribers->Exact.Broadcast(EventData);
+		Subscribers->WithChildren.Broadcast(EventData);
+	}
 
-		if (!OldTimer)
-		{
-			OnTimerRegistered.Broadcast(NewTimer.TimerTag, NewTimer.Duration);
-		}
-		else
+	// The walk ends on the empty tag, which holds the subscriptions to every timer
+	FGameplayTag Tag = EventData.TimerTag;
+	do
+	{
+		Tag = Tag.RequestDirectParent();
+		if (const TUniquePtr<FTimerSubscribers>* Found = TimerSubscribers.Find(Tag))
 		{
-			if (NewTimer.StartTime > 0.0f && OldTimer->StartTime == 0.0f)
-			{
-				OnTimerStarted.Broadcast(NewTimer.TimerTag, NewTimer.Duration);
-			}
-			else if (NewTimer.bIsPaused && !OldTimer->bIsPaused)
-			{
-				OnTimerPaused.Broadcast(NewTimer.TimerTag);
-			}
-			else if (!NewTimer.bIsPaused && OldTimer->bIsPaused)
-			{
-				OnTimerResumed.Broadcast(NewTimer.TimerTag);
-			}
+			(*Found)->WithChildren.Broadcast(EventData);
 		}
 	}
+	while (Tag.IsValid());
+}
+
+void UDynamicTimersComponent::ReportTimerStats(int32 NumActive, int32 NumPaused, int32 NumPending)
+{
+#if STATS
+	// The stats are shared by every component, each one adds the change since its last report
+	INC_DWORD_STAT_BY(STAT_DynamicTimers_ActiveTimers, NumActive - ReportedTimerStats.NumActive);
+	INC_DWORD_STAT_BY(STAT_DynamicTimers_PausedTimers, NumPaused - ReportedTimerStats.NumPaused);
+	INC_DWORD_STAT_BY(STAT_DynamicTimers_PendingTimers, NumPending - ReportedTimerStats.NumPending);
+	ReportedTimerStats = { NumActive, NumPaused, NumPending };
+#endif
+}
+
+
+// Called when the game starts
+void UDynamicTimersComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	bPublishReadSnapshot = GetDefault<UDynamicTimersSettings>()->bPublishReadSnapshots;
+	if (bPublishReadSnapshot && !PostActorTickHandle.IsValid())
+	{
+		// The clock anchor of the read snapshot is refreshed every frame, on clients too
+		PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UDynamicTimersComponent::HandleWorldPostActorTick);
+	}
 
-	for (const FTimeData& OldTimer : Old_ActiveTimers)
+	// Every connection gets a player component for clock sync and its scoped timers
+	if (GetOwnerRole() == ROLE_Authority)
 	{
-		const bool bStillExists = ActiveTimers.ContainsByPredicate([&](const FTimeData& Data)
+		bUseNetDormancy = GetDefault<UDynamicTimersSettings>()->bUseNetDormancy;
+		if (bUseNetDormancy)
 		{
-			return Data.TimerTag.MatchesTagExact(OldTimer.TimerTag);
-		});
+			// Woken for a single update by FlushNetDormancy whenever a commit changes replicated state
+			GetOwner()->SetNetDormancy(DORM_DormantAll);
+		}
 
-		if (!bStillExists)
+		PostLoginHandle = FGameModeEvents::GameModePostLoginEvent.AddUObject(this, &UDynamicTimersComponent::HandleGameModePostLogin);
+		for (FConstPlayerControllerIterator Iterator = GetWorld()->GetPlayerControllerIterator(); Iterator; ++Iterator)
 		{
-			OnTimerFinished.Broadcast(OldTimer.TimerTag);
+			AddPlayerComponent(Iterator->Get());
 		}
 	}
-
-	Old_ActiveTimers = ActiveTimers;
+	else if (const APlayerController* PlayerController = GetWorld()->GetFirstPlayerController())
+	{
+		// Scoped timers may have replicated to the player controller before the game state arrived
+		if (UDynamicTimersPlayerComponent* PlayerComponent = PlayerController->FindComponentByClass<UDynamicTimersPlayerComponent>())
+		{
+			PlayerComponent->ForwardRelevantTimers(*this);
+		}
+	}
+	
 }
 
-void UDynamicTimersComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+void UDynamicTimersComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
-	DOREPLIFETIME(UDynamicTimersComponent, ActiveTimers);
+	FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+	PostActorTickHandle.Reset();
+	FGameModeEvents::GameModePostLoginEvent.Remove(PostLoginHandle);
+	PostLoginHandle.Reset();
+
+	if (UWorld* World = GetWorld())
+	{
+		World->GetTimerManager().ClearTimer(ExpiryTimer.Handle);
+		World->GetTimerManager().ClearTimer(BoundaryTimer.Handle);
+		World->GetTimerManager().ClearTimer(DisplayUpdateTimerHandle);
+	}
+	ExpiryQueue.Reset();
+	BoundaryQueue.Reset();
+	TimerDisplays.Reset();
+	ReportTimerStats(0, 0, 0);
+
+	Super::EndPlay(EndPlayReason);
 }
 
-void UDynamicTimersComponent::OnServerTimerFinished(FGameplayTag TimerTag)
+void UDynamicTimersComponent::HandleGameModePostLogin(AGameModeBase* GameMode, APlayerController* NewPlayer)
 {
-	RemoveGlobalTimer(TimerTag);
+	if (GameMode && GameMode->GetWorld() == GetWorld())
+	{
+		AddPlayerComponent(NewPlayer);
+	}
 }
 
-
-// Called when the game starts
-void UDynamicTimersComponent::BeginPlay()
+UDynamicTimersPlayerComponent* UDynamicTimersComponent::AddPlayerComponent(APlayerController* PlayerController)
 {
-	Super::BeginPlay();
+	if (!PlayerController) return nullptr;
 
-	// ...
-	
+	UDynamicTimersPlayerComponent* PlayerComponent = PlayerController->FindComponentByClass<UDynamicTimersPlayerComponent>();
+	if (!PlayerComponent)
+	{
+		PlayerComponent = NewObject<UDynamicTimersPlayerComponent>(PlayerController, TEXT("DynamicTimersPlayerComponent"));
+		PlayerComponent->RegisterComponent();
+	}
+
+	if (!PlayerComponents.Contains(PlayerComponent))
+	{
+		PlayerComponents.Add(PlayerComponent);
+
+		// Scoped timers registered before the component existed (e.g. from a Blueprint OnPostLogin) reached nobody
+		SyncRelevantTimers(*PlayerComponent);
+	}
+	return PlayerComponent;
 }
 
+void UDynamicTimersComponent::SyncRelevantTimers(UDynamicTimersPlayerComponent& PlayerComponent)
+{
+	for (const FTimeData& TimerData : ActiveTimers.Items)
+	{
+		if (TimerData.Scope == EDTTimerScope::Global) continue;
+
+		if (DynamicTimersPrivate::IsTimerRelevantTo(TimerData, PlayerComponent))
+		{
+			PlayerComponent.UpsertRelevantTimer(TimerData);
+		}
+		else
+		{
+			PlayerComponent.RemoveRelevantTimer(TimerData.TimerTag);
+		}
+	}
+}
@@ -0,0 +1,294 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Components/DynamicTimersPlayerComponent.h"
+
+#include "Components/DynamicTimersComponent.h"
+#include "Engine/World.h"
+#include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/WorldSettings.h"
+#include "Settings/DynamicTimersSettings.h"
+#include "TimerManager.h"
+
+namespace DynamicTimersClock
+{
+	// Spacing of the initial burst of round trips
+	constexpr float BurstInterval = 0.2f;
+
+	// Fraction of a measured error applied to the offset and to the drift rate per sample
+	constexpr double OffsetGain = 0.5;
+	constexpr double DriftGain = 0.25;
+
+	// Clocks that disagree by more than this rate are resynced by snapping, not tracked as drift
+	constexpr double MaxDrift = 0.01;
+}
+
+UDynamicTimersPlayerComponent::UDynamicTimersPlayerComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+	SetIsReplicatedByDefault(true);
+}
+
+void UDynamicTimersPlayerComponent::PostInitProperties()
+{
+	Super::PostInitProperties();
+
+	RelevantTimers.Owner = this;
+}
+
+void UDynamicTimersPlayerComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	FDoRepLifetimeParams Params;
+	Params.Condition = COND_OwnerOnly;
+	Params.bIsPushBased = true;
+	DOREPLIFETIME_WITH_PARAMS_FAST(UDynamicTimersPlayerComponent, RelevantTimers, Params);
+}
+
+double UDynamicTimersPlayerComponent::GetServerTime() const
+{
+	const UWorld* World = GetWorld();
+	if (!World) return 0.0;
+
+	if (GetOwner()->HasAuthority())
+	{
+		return World->GetTimeSeconds();
+	}
+
+	if (bHasClockSync)
+	{
+		const double LocalTime = GetLocalTime();
+		return LocalTime + ClockOffset + ClockDrift * (LocalTime - OffsetLocalTime);
+	}
+
+	// Until the first round trip completes, the game state's coarse replicated time is the best we have
+	const AGameStateBase* GameState = World->GetGameState();
+	return GameState ? GameState->GetServerWorldTimeSeconds() : World->GetTimeSeconds();
+}
+
+void UDynamicTimersPlayerComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	const APlayerController* PlayerController = CastChecked<APlayerController>(GetOwner());
+	if (!PlayerController->HasAuthority() && PlayerController->IsLocalController())
+	{
+		BurstRequestsRemaining = GetDefault<UDynamicTimersSettings>()->ClockSyncBurstCount;
+		SendClockSyncRequest();
+	}
+}
+
+void UDynamicTimersPlayerComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UWorld* World = GetWorld())
+	{
+		World->GetTimerManager().ClearTimer(ClockSyncTimerHandle);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UDynamicTimersPlayerComponent::ServerPredictTimerOperation_Implementation(uint16 PredictionId, FGameplayTag TimerTag, EDTTimerOperation Operation, double PredictedTime)
+{
+	UDynamicTimersComponent* TimersComponent = FindTimersComponent();
+	if (!TimersComponent || !TimersComponent->ApplyPredictedTimerOperation(CastChecked<APlayerController>(GetOwner()), PredictionId, TimerTag, Operation, PredictedTime))
+	{
+		ClientRejectTimerPrediction(PredictionId, TimerTag);
+	}
+}
+
+void UDynamicTimersPlayerComponent::ClientRejectTimerPrediction_Implementation(uint16 PredictionId, FGameplayTag TimerTag)
+{
+	if (UDynamicTimersComponent* TimersComponent = FindTimersComponent())
+	{
+		TimersComponent->HandleTimerPredictionRejected(PredictionId, TimerTag);
+	}
+}
+
+void UDynamicTimersPlayerComponent::ServerRequestServerTime_Implementation(double ClientSendTime)
+{
+	ClientReceiveServerTime(ClientSendTime, GetWorld()->GetTimeSeconds());
+}
+
+void UDynamicTimersPlayerComponent::ClientReceiveServerTime_Implementation(double ClientSendTime, double ServerTime)
+{
+	const double LocalTime = GetLocalTime();
+	const double RoundTripTime = LocalTime - ClientSendTime;
+	if (RoundTripTime < 0.0) return;
+
+	// The server stamped its reply roughly half a round trip before it arrived
+	ApplyClockSample(LocalTime, RoundTripTime, ServerTime + RoundTripTime * 0.5 - LocalTime);
+}
+
+void UDynamicTimersPlayerComponent::SendClockSyncRequest()
+{
+	ServerRequestServerTime(GetLocalTime());
+	ScheduleNextClockSync();
+}
+
+void UDynamicTimersPlayerComponent::ScheduleNextClockSync()
+{
+	float Delay = GetDefault<UDynamicTimersSettings>()->ClockSyncInterval;
+	if (BurstRequestsRemaining > 0)
+	{
+		--BurstRequestsRemaining;
+		Delay = DynamicTimersClock::BurstInterval;
+	}
+
+	GetWorld()->GetTimerManager().SetTimer(ClockSyncTimerHandle, this, &UDynamicTimersPlayerComponent::SendClockSyncRequest, Delay, false);
+}
+
+void UDynamicTimersPlayerComponent::ApplyClockSample(double LocalTime, double RoundTripTime, double SampleOffset)
+{
+	using namespace DynamicTimersClock;
+
+	if (ClockSamples.Num() < MaxClockSamples)
+	{
+		ClockSamples.Add({ RoundTripTime, SampleOffset });
+	}
+	else
+	{
+		ClockSamples[NextSampleSlot] = { RoundTripTime, SampleOffset };
+	}
+	NextSampleSlot = (NextSampleSlot + 1) % MaxClockSamples;
+
+	const FClockSample* BestSample = &ClockSamples[0];
+	for (const FClockSample& Sample : ClockSamples)
+	{
+		if (Sample.RoundTripTime < BestSample->RoundTripTime)
+		{
+			BestSample = &Sample;
+		}
+	}
+	BestRoundTripTime = BestSample->RoundTripTime;
+
+	const double PredictedOffset = ClockOffset + ClockDrift * (LocalTime - OffsetLocalTime);
+	const double Error = BestSample->Offset - PredictedOffset;
+
+	if (!bHasClockSync || FMath::Abs(Error) > GetDefault<UDynamicTimersSettings>()->ClockSnapThreshold)
+	{
+		// First estimate, or the clocks jumped apart (hitch, dilation change): older samples no longer apply
+		ClockOffset = SampleOffset;
+		ClockDrift = 0.0;
+		ClockSamples.Reset();
+		ClockSamples.Add({ RoundTripTime, SampleOffset });
+		NextSampleSlot = 1;
+		BestRoundTripTime = RoundTripTime;
+		bHasClockSync = true;
+	}
+	else
+	{
+		// Slew towards the estimate and fold the error that keeps coming back into the drift rate
+		const double Elapsed = LocalTime - OffsetLocalTime;
+		if (Elapsed > UE_SMALL_NUMBER)
+		{
+			ClockDrift = FMath::Clamp(ClockDrift + DriftGain * Error / Elapsed, -MaxDrift, MaxDrift);
+		}
+		ClockOffset = PredictedOffset + OffsetGain * Error;
+	}
+	OffsetLocalTime = LocalTime;
+}
+
+double UDynamicTimersPlayerComponent::GetLocalTime() const
+{
+	// Real time run at the rate of the server's world clock: the replicated effective time dilation, stopped while
+	// paused. The local world clock runs at that rate too but clamps hitches, which the estimate would take for drift.
+	const double RealTime = FPlatformTime::Seconds();
+	const UWorld* World = GetWorld();
+	const AWorldSettings* WorldSettings = World ? World->GetWorldSettings() : nullptr;
+	const double Rate = World && World->IsPaused() ? 0.0 : WorldSettings ? WorldSettings->GetEffectiveTimeDilation() : 1.0;
+
+	if (Rate != LocalClockRate)
+	{
+		LocalClockTime += (RealTime - LocalClockRealTime) * LocalClockRate;
+		LocalClockRealTime = RealTime;
+		LocalClockRate = Rate;
+	}
+	return LocalClockTime + (RealTime - LocalClockRealTime) * LocalClockRate;
+}
+
+void UDynamicTimersPlayerComponent::UpsertRelevantTimer(const FTimeData& TimerData)
+{
+	// Per-connection sets are small, a scan is cheaper than keeping another index in sync
+	FTimeData* RelevantTimer = RelevantTimers.Items.FindByPredicate([&TimerData](const FTimeData& Item)
+	{
+		return Item.TimerTag == TimerData.TimerTag;
+	});
+
+	if (RelevantTimer)
+	{
+		RelevantTimer->CopyStateFrom(TimerData);
+	}
+	else
+	{
+		RelevantTimer = &RelevantTimers.Items.Add_GetRef(TimerData);
+	}
+	RelevantTimers.MarkItemDirty(*RelevantTimer);
+	MARK_PROPERTY_DIRTY_FROM_NAME(UDynamicTimersPlayerComponent, RelevantTimers, this);
+}
+
+void UDynamicTimersPlayerComponent::RemoveRelevantTimer(const FGameplayTag& TimerTag)
+{
+	const int32 Index = RelevantTimers.Items.IndexOfByPredicate([&TimerTag](const FTimeData& Item)
+	{
+		return Item.TimerTag == TimerTag;
+	});
+
+	if (Index != INDEX_NONE)
+	{
+		RelevantTimers.Items.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+		RelevantTimers.MarkArrayDirty();
+		MARK_PROPERTY_DIRTY_FROM_NAME(UDynamicTimersPlayerComponent, RelevantTimers, this);
+	}
+}
+
+void UDynamicTimersPlayerComponent::HandleRelevantTimerAdded(const FTimeData& TimerData)
+{
+	if (UDynamicTimersComponent* TimersComponent = FindTimersComponent())
+	{
+		TimersComponent->AddMirroredTimer(TimerData);
+	}
+}
+
+void UDynamicTimersPlayerComponent::HandleRelevantTimerChanged(const FTimeData& TimerData)
+{
+	if (UDynamicTimersComponent* TimersComponent = FindTimersComponent())
+	{
+		TimersComponent->UpdateMirroredTimer(TimerData);
+	}
+}
+
+void UDynamicTimersPlayerComponent::HandleRelevantTimerRemoved(const FTimeData& TimerData)
+{
+	if (UDynamicTimersComponent* TimersComponent = FindTimersComponent())
+	{
+		TimersComponent->RemoveMirroredTimer(TimerData.TimerTag);
+	}
+}
+
+void UDynamicTimersPlayerComponent::HandleRelevantTimersReceived()
+{
+	if (UDynamicTimersComponent* TimersComponent = FindTimersComponent())
+	{
+		TimersComponent->HandleTimersReceived();
+	}
+}
+
+void UDynamicTimersPlayerComponent::ForwardRelevantTimers(UDynamicTimersComponent& TimersComponent) const
+{
+	for (const FTimeData& TimerData : RelevantTimers.Items)
+	{
+		TimersComponent.AddMirroredTimer(TimerData);
+	}
+	TimersComponent.HandleTimersReceived();
+}
+
+UDynamicTimersComponent* UDynamicTimersPlayerComponent::FindTimersComponent() const
+{
+	const AGameStateBase* GameState = GetWorld() ? GetWorld()->GetGameState() : nullptr;
+	return GameState ? GameState->FindComponentByClass<UDynamicTimersComponent>() : nullptr;
+}
@@ -0,0 +1,125 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Data/DynamicTimerCatalog.h"
+
+#include "DynamicTimers.h"
+#if WITH_EDITOR
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#endif
+
+#if WITH_EDITOR
+namespace DynamicTimerCatalogPrivate
+{
+	bool IsPlayInEditorRunning(const UWorld* IgnoredWorld)
+	{
+		for (const FWorldContext& Context : GEngine->GetWorldContexts())
+		{
+			if (Context.WorldType == EWorldType::PIE && Context.World() && Context.World() != IgnoredWorld)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+}
+#endif
+
+void UDynamicTimerCatalog::PostLoad()
+{
+	Super::PostLoad();
+
+	BuildPrototypes();
+}
+
+#if WITH_EDITOR
+void UDynamicTimerCatalog::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	// Running sessions replicate definition indices in the current order, re-sorting under them would resolve
+	// their timers to other definitions. The rebuild waits until the last of them ends.
+	if (DynamicTimerCatalogPrivate::IsPlayInEditorRunning(nullptr))
+	{
+		if (!DeferredRebuildHandle.IsValid())
+		{
+			UE_LOG(LogDynamicTimers, Warning, TEXT("%s: edited during Play In Editor, the changes apply once the session ends"), *GetName());
+			DeferredRebuildHandle = FWorldDelegates::OnWorldCleanup.AddUObject(this, &UDynamicTimerCatalog::HandleWorldCleanup);
+		}
+		return;
+	}
+
+	BuildPrototypes();
+}
+
+void UDynamicTimerCatalog::HandleWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources)
+{
+	if (!World || World->WorldType != EWorldType::PIE || DynamicTimerCatalogPrivate::IsPlayInEditorRunning(World)) return;
+
+	FWorldDelegates::OnWorldCleanup.Remove(DeferredRebuildHandle);
+	DeferredRebuildHandle.Reset();
+	BuildPrototypes();
+}
+#endif
+
+int32 UDynamicTimerCatalog::FindDefinitionIndex(const FGameplayTag& TimerTag) const
+{
+	const int32* Index = IndexByTag.Find(TimerTag);
+	return Index ? *Index : INDEX_NONE;
+}
+
+const FTimeData* UDynamicTimerCatalog::GetPrototype(int32 DefinitionIndex) const
+{
+	return Prototypes.IsValidIndex(DefinitionIndex) ? &Prototypes[DefinitionIndex] : nullptr;
+}
+
+void UDynamicTimerCatalog::BuildPrototypes()
+{
+	Prototypes.Reset();
+	IndexByTag.Reset();
+
+	TArray<const FDTTimerDefinition*> SortedDefinitions;
+	for (const FDTTimerDefinition& Definition : Definitions)
+	{
+		if (Definition.TimerTag.IsValid())
+		{
+			SortedDefinitions.Add(&Definition);
+		}
+	}
+	SortedDefinitions.StableSort([](const FDTTimerDefinition& A, const FDTTimerDefinition& B)
+	{
+		return A.TimerTag.GetTagName().Compare(B.TimerTag.GetTagName()) < 0;
+	});
+
+	Prototypes.Reserve(SortedDefinitions.Num());
+	for (const FDTTimerDefinition* Definition : SortedDefinitions)
+	{
+		if (IndexByTag.Contains(Definition->TimerTag))
+		{
+			UE_LOG(LogDynamicTimers, Warning, TEXT("%s: %s is defined more than once, the first definition is used"), *GetName(), *Definition->TimerTag.ToString());
+			continue;
+		}
+
+		FTimeData Prototype;
+		Prototype.TimerTag = Definition->TimerTag;
+		Prototype.Duration = DynamicTimers::QuantizeNetTime(Definition->Duration);
+		Prototype.bLooping = Definition->bLooping;
+		Prototype.TimeScale = FMath::Max(Definition->TimeScale, DynamicTimers::MinTimeScale);
+		Prototype.bIgnoreTimeDilation = Definition->bIgnoreTimeDilation;
+		Prototype.Scope = Definition->Scope;
+		Prototype.TeamId = Definition->TeamId;
+
+		if (!Definition->Phases.IsEmpty() && !Prototype.SetPhases(Definition->Phases)) continue;
+		if (Prototype.Duration <= 0.0f)
+		{
+			UE_LOG(LogDynamicTimers, Warning, TEXT("%s: %s has no duration"), *GetName(), *Definition->TimerTag.ToString());
+			continue;
+		}
+		Prototype.SetThresholds(Definition->Thresholds);
+
+		Prototype.DefinitionIndex = Prototypes.Num();
+		IndexByTag.Add(Prototype.TimerTag, Prototype.DefinitionIndex);
+		Prototypes.Add(MoveTemp(Prototype));
+	}
+}
@@ -0,0 +1,248 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CoreMinimal.h"
+
+#if !UE_BUILD_SHIPPING
+
+#include "DynamicTimers.h"
+#include "GameplayTagsManager.h"
+#include "Components/DynamicTimersComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+/**
+ * Times the component's hot paths at several timer counts and writes the results as CSV,
+ * so runs before and after an engine or plugin change can be compared.
+ * Runs headless too, e.g. -nullrhi -ExecCmds="DynamicTimers.Benchmark 20".
+ */
+struct FDynamicTimersBenchmark
+{
+	struct FResult
+	{
+		const TCHAR* Name;
+		int32 NumTimers = 0;
+
+		// Differs from NumTimers when the project has fewer tags than the run asked for
+		int32 RequestedTimers = 0;
+		int32 Iterations = 0;
+		double MinSeconds = TNumericLimits<double>::Max();
+		double TotalSeconds = 0.0;
+	};
+
+	static void Run(const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar);
+
+private:
+	static void RunWithTimerCount(AActor& Host, AActor& ClientHost, TConstArrayView<FGameplayTag> TimerTags, int32 RequestedTimers, int32 Iterations, TArray<FResult>& OutResults);
+
+	template<typename FuncType>
+	static void Measure(FResult& Result, FuncType&& Func)
+	{
+		const double StartSeconds = FPlatformTime::Seconds();
+		Func();
+		const double ElapsedSeconds = FPlatformTime::Seconds() - StartSeconds;
+
+		Result.TotalSeconds += ElapsedSeconds;
+		Result.MinSeconds = FMath::Min(Result.MinSeconds, ElapsedSeconds);
+		++Result.Iterations;
+	}
+};
+
+void FDynamicTimersBenchmark::Run(const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+{
+	if (!World || World->GetNetMode() == NM_Client)
+	{
+		Ar.Log(TEXT("DynamicTimers.Benchmark needs a server or standalone world"));
+		return;
+	}
+
+	const int32 Iterations = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 10;
+
+	// Every timer needs its own registered tag, so the larger runs are capped by the tags the project defines
+	FGameplayTagContainer AllTags;
+	UGameplayTagsManager::Get().RequestAllGameplayTags(AllTags, true);
+	const TArray<FGameplayTag>& AvailableTags = AllTags.GetGameplayTagArray();
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.ObjectFlags |= RF_Transient;
+	AActor* Host = World->SpawnActor<AActor>(SpawnParameters);
+	AActor* ClientHost = World->SpawnActor<AActor>(SpawnParameters);
+	if (!Host || !ClientHost) return;
+
+	// Gives the receiving component the client's role, so the replicated change path runs as it does on a client
+	ClientHost->SetRole(ROLE_SimulatedProxy);
+
+	TArray<FResult> Results;
+	for (const int32 RequestedTimers : { 10, 1000, 10000 })
+	{
+		const int32 NumTimers = FMath::Min(RequestedTimers, AvailableTags.Num());
+		if (NumTimers < RequestedTimers)
+		{
+			UE_LOG(LogDynamicTimers, Warning, TEXT("DynamicTimers.Benchmark: only %d gameplay tags are registered, running %d timers instead of %d"), AvailableTags.Num(), NumTimers, RequestedTimers);
+		}
+
+		if (NumTimers > 0)
+		{
+			RunWithTimerCount(*Host, *ClientHost, MakeArrayView(AvailableTags.GetData(), NumTimers), RequestedTimers, Iterations, Results);
+		}
+	}
+
+	Host->Destroy();
+	ClientHost->Destroy();
+
+	// Runs capped by the project's tag count keep the count they asked for next to the one they ran
+	FString Csv = TEXT("Benchmark,Timers,RequestedTimers,Iterations,MinMs,MeanMs,MeanNsPerTimer\n");
+	for (const FResult& Result : Results)
+	{
+		const double MeanSeconds = Result.TotalSeconds / FMath::Max(Result.Iterations, 1);
+		Csv += FString::Printf(TEXT("%s,%d,%d,%d,%.4f,%.4f,%.1f\n"), Result.Name, Result.NumTimers, Result.RequestedTimers, Result.Iterations,
+			Result.MinSeconds * 1000.0, MeanSeconds * 1000.0, MeanSeconds * 1.0e9 / FMath::Max(Result.NumTimers, 1));
+	}
+	Ar.Log(Csv);
+
+	const FString CsvPath = FPaths::ProfilingDir() / TEXT("DynamicTimers") / FString::Printf(TEXT("Benchmark-%s.csv"), *FDateTime::Now().ToString());
+	if (FFileHelper::SaveStringToFile(Csv, *CsvPath))
+	{
+		Ar.Logf(TEXT("Wrote %s"), *CsvPath);
+	}
+}
+
+void FDynamicTimersBenchmark::RunWithTimerCount(AActor& Host, AActor& ClientHost, TConstArrayView<FGameplayTag> TimerTags, int32 RequestedTimers, int32 Iterations, TArray<FResult>& OutResults)
+{
+	UDynamicTimersComponent* Component = NewObject<UDynamicTimersComponent>(&Host);
+	Component->RegisterComponent();
+
+	// Receives the server component's timers the way the fast array hands them to a client
+	UDynamicTimersComponent* ClientComponent = NewObject<UDynamicTimersComponent>(&ClientHost);
+	ClientComponent->RegisterComponent();
+
+	const int32 NumTimers = TimerTags.Num();
+
+	// Long enough that nothing expires while the benchmark runs
+	TArray<FBulkTimerRegistrationData> Registrations;
+	Registrations.Reserve(NumTimers);
+	FGameplayTagContainer TagContainer;
+	for (const FGameplayTag& TimerTag : TimerTags)
+	{
+		FBulkTimerRegistrationData& Registration = Registrations.AddDefaulted_GetRef();
+		Registration.TimerTag = TimerTag;
+		Registration.Duration = 1.0e6f;
+		TagContainer.AddTagFast(TimerTag);
+	}
+
+	FResult Register { TEXT("RegisterGlobalTimers"), NumTimers, RequestedTimers };
+	FResult Start { TEXT("StartGlobalTimers"), NumTimers, RequestedTimers };
+	FResult Pause { TEXT("PauseGlobalTimers"), NumTimers, RequestedTimers };
+	FResult Query { TEXT("GetTimerRemainingTime"), NumTimers, RequestedTimers };
+	FResult Receive { TEXT("ReplicatedChangeReceive"), NumTimers, RequestedTimers };
+	FResult Restore { TEXT("RestoreTimerSnapshot"), NumTimers, RequestedTimers };
+
+	const auto RemoveAllTimers = [&]
+	{
+		FDynamicTimersBatchScope Batch(Component);
+		for (const FGameplayTag& TimerTag : TimerTags)
+		{
+			Component->RemoveGlobalTimer(TimerTag);
+		}
+	};
+
+	TArray<uint8> Snapshot;
+
+	float RemainingTimeSum = 0.0f;
+	for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+	{
+		// Each mutation is timed through its commit, so replication marking and event flushing are included
+		Measure(Register, [&]
+		{
+			FDynamicTimersBatchScope Batch(Component);
+			Component->RegisterGlobalTimers(Registrations);
+		});
+
+		Measure(Start, [&]
+		{
+			FDynamicTimersBatchScope Batch(Component);
+			Component->StartGlobalTimers(TagContainer);
+		});
+
+		Measure(Pause, [&]
+		{
+			FDynamicTimersBatchScope Batch(Component);
+			Component->PauseGlobalTimers(TagContainer);
+		});
+
+		Measure(Query, [&]
+		{
+			for (const FGameplayTag& TimerTag : TimerTags)
+			{
+				float RemainingTime = 0.0f;
+				Component->GetTimerRemainingTime(TimerTag, RemainingTime);
+				RemainingTimeSum += RemainingTime;
+			}
+		});
+
+		// The client first receives the paused timers as new items, untimed
+		TArray<FTimeData>& ClientTimers = ClientComponent->ActiveTimers.Items;
+		for (const FTimeData& TimerData : Component->ActiveTimers.Items)
+		{
+			ClientTimers.AddDefaulted_GetRef().CopyStateFrom(TimerData);
+		}
+		for (FTimeData& TimerData : ClientTimers)
+		{
+			TimerData.PostReplicatedAdd(ClientComponent->ActiveTimers);
+		}
+		ClientComponent->HandleTimersReceived();
+
+		{
+			FDynamicTimersBatchScope Batch(Component);
+			Component->ResumeGlobalTimers(TagContainer);
+		}
+
+		// What a client does after the update that resumed every timer: per-item change callbacks, then one flush
+		for (int32 Index = 0; Index < ClientTimers.Num(); ++Index)
+		{
+			ClientTimers[Index].CopyStateFrom(Component->ActiveTimers.Items[Index]);
+		}
+		Measure(Receive, [&]
+		{
+			for (FTimeData& TimerData : ClientTimers)
+			{
+				TimerData.PostReplicatedChange(ClientComponent->ActiveTimers);
+			}
+			ClientComponent->HandleTimersReceived();
+		});
+
+		for (FTimeData& TimerData : ClientTimers)
+		{
+			TimerData.PreReplicatedRemove(ClientComponent->ActiveTimers);
+		}
+		ClientTimers.Reset();
+		ClientComponent->HandleTimersReceived();
+
+		// Restored into an empty component, as after travel or a restart
+		Component->ExportTimerSnapshot(Snapshot);
+		RemoveAllTimers();
+		Measure(Restore, [&]
+		{
+			Component->RestoreTimerSnapshot(Snapshot);
+		});
+
+		RemoveAllTimers();
+	}
+
+	Component->DestroyComponent();
+	ClientComponent->DestroyComponent();
+
+	UE_LOG(LogDynamicTimers, Verbose, TEXT("DynamicTimers.Benchmark: checksum %f"), RemainingTimeSum);
+	OutResults.Append({ Register, Start, Pause, Query, Receive, Restore });
+}
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice DynamicTimersBenchmarkCommand(
+	TEXT("DynamicTimers.Benchmark"),
+	TEXT("Times timer registration, bulk start/pause, remaining time queries, the replicated change path and snapshot restores at 10, 1k and 10k timers, and writes the results as CSV to the profiling directory. Usage: DynamicTimers.Benchmark [Iterations]"),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateStatic(&FDynamicTimersBenchmark::Run));
+
+#endif
@@ -0,0 +1,87 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CoreMinimal.h"
+
+#if !UE_BUILD_SHIPPING
+
+#include "Components/DynamicTimersComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/UObjectIterator.h"
+
+/** Prints the live timer table of every timers component in a world, as seen from that machine */
+struct FDynamicTimersDump
+{
+	static void Run(const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar);
+
+private:
+	static void DumpComponent(const UDynamicTimersComponent& Component, FOutputDevice& Ar);
+};
+
+void FDynamicTimersDump::Run(const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+{
+	if (!World) return;
+
+	int32 NumComponents = 0;
+	for (TObjectIterator<UDynamicTimersComponent> It; It; ++It)
+	{
+		if (It->GetWorld() == World && !It->IsTemplate())
+		{
+			DumpComponent(**It, Ar);
+			++NumComponents;
+		}
+	}
+
+	if (NumComponents == 0)
+	{
+		Ar.Log(TEXT("No timers component in this world"));
+	}
+}
+
+void FDynamicTimersDump::DumpComponent(const UDynamicTimersComponent& Component, FOutputDevice& Ar)
+{
+	static const TCHAR* ScopeNames[] = { TEXT("Global"), TEXT("Team"), TEXT("Player") };
+
+	const double ServerTime = Component.GetServerTime();
+
+	Ar.Logf(TEXT("%s (%s): %d timers, %d started, %d paused, server time %.3f"),
+		*GetNameSafe(Component.GetOwner()),
+		Component.GetOwnerRole() == ROLE_Authority ? TEXT("authority") : TEXT("client"),
+		Component.GetNumTimers(), Component.NumStartedTimers, Component.NumPausedTimers, ServerTime);
+
+	// Clients list the scoped timers they mirror after the replicated ones
+	for (const TArray<FTimeData>* Timers : { &Component.ActiveTimers.Items, &Component.MirroredTimers })
+	{
+		for (const FTimeData& TimerData : *Timers)
+		{
+			const TCHAR* State = !TimerData.bIsStarted ? TEXT("Pending") : TimerData.bIsPaused ? TEXT("Paused") : TEXT("Running");
+
+			FString Details;
+			if (TimerData.bLooping)
+			{
+				Details += TEXT(" looping");
+			}
+			if (!TimerData.Phases.IsEmpty())
+			{
+				Details += FString::Printf(TEXT(" phases=%d"), TimerData.Phases.Num());
+			}
+			if (TimerData.Scope == EDTTimerScope::Team)
+			{
+				Details += FString::Printf(TEXT(" team=%d"), TimerData.TeamId);
+			}
+
+			Ar.Logf(TEXT("  %-40s %-8s remaining %9.3f / %9.3f  rate %.3f  %s%s"),
+				*TimerData.TimerTag.ToString(), State,
+				TimerData.GetRemainingTime(ServerTime), TimerData.Duration, TimerData.Rate,
+				ScopeNames[static_cast<uint8>(TimerData.Scope)], *Details);
+		}
+	}
+}
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice DynamicTimersDumpCommand(
+	TEXT("DynamicTimers.Dump"),
+	TEXT("Lists every timer of the world's timers components with its state, remaining time, duration, rate and scope."),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateStatic(&FDynamicTimersDump::Run));
+
+#endif
@@ -0,0 +1,471 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CoreMinimal.h"
+
+#if !UE_BUILD_SHIPPING
+
+#include "DynamicTimers.h"
+#include "GameplayTagsManager.h"
+#include "Components/DynamicTimersComponent.h"
+#include "Containers/Ticker.h"
+#include "Engine/Engine.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/GameStateBase.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+/**
+ * Replication regression harness for real server and client processes on one machine. The server runs a scripted
+ * workload and reports the bytes each operation puts on the wire, clients report how long after the server's
+ * mutation their OnTimerStarted and OnTimerFinished fired. Lag and loss come from the engine's NetEmulation.*
+ * settings. Headless, e.g. with -server -nullrhi on one side and -nullrhi 127.0.0.1 on the other.
+ * The workload runs on a timers component of its own, on a replicated actor it spawns, so it never touches the
+ * game state's timers.
+ */
+struct FDynamicTimersNetHarness
+{
+	static void RunWorkload(const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar);
+	static void Listen(const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar);
+	static void Report(const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar);
+
+private:
+	enum class EStep : uint8
+	{
+		WaitForClients,
+		Register,
+		Start,
+		Pause,
+		Resume,
+		Expire,
+		Done
+	};
+
+	struct FWorkload
+	{
+		TWeakObjectPtr<UWorld> World;
+		TWeakObjectPtr<AActor> Host;
+		TWeakObjectPtr<UDynamicTimersComponent> Component;
+		TArray<FGameplayTag> TimerTags;
+		FGameplayTagContainer TagContainer;
+		int32 NumClients = 1;
+		int32 NumCycles = 5;
+		int32 Cycle = 0;
+		EStep Step = EStep::WaitForClients;
+		double NextStepTime = 0.0;
+		uint64 StepStartBytes = 0;
+		bool bQuitWhenDone = false;
+		FString Csv;
+		FTSTicker::FDelegateHandle TickerHandle;
+	};
+
+	struct FListener
+	{
+		TWeakObjectPtr<UDynamicTimersComponent> Component;
+		FDelegateHandle SubscriptionHandle;
+		TMap<FGameplayTag, double> ExpectedFinishTimes;
+		TArray<double> StartLatencies;
+		TArray<double> FinishLatencies;
+		uint64 StartBytesReceived = 0;
+		bool bQuitWhenDone = false;
+		FTSTicker::FDelegateHandle TickerHandle;
+		FDelegateHandle WorldCleanupHandle;
+	};
+
+	static constexpr float TimerDuration = 2.0f;
+
+	// Long enough for the net driver to send each step before the next one is measured
+	static constexpr double StepInterval = 0.5;
+
+	static bool TickWorkload(float DeltaTime);
+	static void BeginStep(FWorkload& Workload, UDynamicTimersComponent& Component);
+	static void EndStep(FWorkload& Workload, int32 NumConnections);
+
+	static bool TickListener(float DeltaTime);
+	static void HandleTimerEvent(const FDTTimerEventData& EventData);
+	static void HandleWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources);
+	static void StopListening(FOutputDevice& Ar);
+
+	static UDynamicTimersComponent* SpawnHarnessComponent(UWorld& World);
+	static UDynamicTimersComponent* FindHarnessComponent(UWorld& World);
+	static FString DescribeLatencies(const TCHAR* Name, TArray<double>& Latencies);
+	static void WriteCsv(const FString& Csv, const TCHAR* Name, FOutputDevice& Ar);
+
+	static const TCHAR* GetStepName(EStep Step);
+
+	static TUniquePtr<FWorkload> Workload;
+	static TUniquePtr<FListener> Listener;
+};
+
+TUniquePtr<FDynamicTimersNetHarness::FWorkload> FDynamicTimersNetHarness::Workload;
+TUniquePtr<FDynamicTimersNetHarness::FListener> FDynamicTimersNetHarness::Listener;
+
+void FDynamicTimersNetHarness::RunWorkload(const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+{
+	// Without clients to wait for, any world with authority runs every step, though nothing goes on the wire
+	const int32 NumClients = Args.Num() > 0 ? FMath::Max(0, FCString::Atoi(*Args[0])) : 1;
+	if (!World || World->GetNetMode() == NM_Client || (World->GetNetMode() == NM_Standalone && NumClients > 0))
+	{
+		Ar.Log(TEXT("DynamicTimers.NetHarness.Run needs a listen or dedicated server"));
+		return;
+	}
+	if (Workload.IsValid())
+	{
+		Ar.Log(TEXT("DynamicTimers.NetHarness.Run: a workload is already running"));
+		return;
+	}
+
+	FGameplayTagContainer AllTags;
+	UGameplayTagsManager::Get().RequestAllGameplayTags(AllTags, true);
+	const TArray<FGameplayTag>& AvailableTags = AllTags.GetGameplayTagArray();
+
+	const int32 NumTimers = FMath::Min(Args.Num() > 1 ? FMath::Max(1, FCString::Atoi(*Args[1])) : 50, AvailableTags.Num());
+	if (NumTimers == 0)
+	{
+		Ar.Log(TEXT("DynamicTimers.NetHarness.Run: every timer needs a gameplay tag and the project defines none"));
+		return;
+	}
+
+	UDynamicTimersComponent* Component = SpawnHarnessComponent(*World);
+	if (!Component) return;
+
+	Workload = MakeUnique<FWorkload>();
+	Workload->World = World;
+	Workload->Host = Component->GetOwner();
+	Workload->Component = Component;
+	Workload->NumClients = NumClients;
+	Workload->NumCycles = Args.Num() > 2 ? FMath::Max(1, FCString::Atoi(*Args[2])) : 5;
+	Workload->bQuitWhenDone = Args.Contains(TEXT("Quit"));
+
+	Workload->TimerTags.Append(AvailableTags.GetData(), NumTimers);
+	for (const FGameplayTag& TimerTag : Workload->TimerTags)
+	{
+		Workload->TagContainer.AddTagFast(TimerTag);
+	}
+	Workload->Csv = TEXT("Cycle,Step,Timers,Connections,Bytes,BytesPerTimerPerConnection\n");
+
+	Ar.Logf(TEXT("DynamicTimers.NetHarness: waiting for %d clients, then %d cycles over %d timers"), Workload->NumClients, Workload->NumCycles, NumTimers);
+	Workload->TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateStatic(&FDynamicTimersNetHarness::TickWorkload));
+}
+
+bool FDynamicTimersNetHarness::TickWorkload(float DeltaTime)
+{
+	UWorld* World = Workload->World.Get();
+	UDynamicTimersComponent* Component = Workload->Component.Get();
+	if (!World || !Component)
+	{
+		UE_LOG(LogDynamicTimers, Warning, TEXT("DynamicTimers.NetHarness: the server world or the harness's timers component went away, workload aborted"));
+		if (AActor* Host = Workload->Host.Get())
+		{
+			Host->Destroy();
+		}
+		Workload.Reset();
+		return false;
+	}
+
+	const double Now = FPlatformTime::Seconds();
+	if (Now < Workload->NextStepTime) return true;
+
+	const UNetDriver* NetDriver = World->GetNetDriver();
+	const int32 NumConnections = NetDriver ? NetDriver->ClientConnections.Num() : 0;
+	if (Workload->Step == EStep::WaitForClients && NumConnections < Workload->NumClients) return true;
+
+	EndStep(*Workload, NumConnections);
+
+	switch (Workload->Step)
+	{
+	case EStep::WaitForClients:
+		Workload->Step = EStep::Register;
+		break;
+	case EStep::Expire:
+		Workload->Step = ++Workload->Cycle < Workload->NumCycles ? EStep::Register : EStep::Done;
+		break;
+	default:
+		Workload->Step = static_cast<EStep>(static_cast<uint8>(Workload->Step) + 1);
+		break;
+	}
+
+	if (Workload->Step == EStep::Done)
+	{
+		const DynamicTimers::FNetTrafficCounters& Counters = DynamicTimers::GetNetTrafficCounters();
+		// Full states sent to clients that joined while timers existed; the last column is their average size
+		Workload->Csv += FString::Printf(TEXT("-,JoinInProgress,-,%u,%llu,%.2f\n"), Counters.NumInitialSends, Counters.InitialBytesSent,
+			Counters.NumInitialSends > 0 ? static_cast<double>(Counters.InitialBytesSent) / Counters.NumInitialSends : 0.0);
+		WriteCsv(Workload->Csv, TEXT("NetWorkload"), *GLog);
+
+		// Clients see their copy of the component go away, which ends their listeners too
+		if (AActor* Host = Workload->Host.Get())
+		{
+			Host->Destroy();
+		}
+
+		const bool bQuit = Workload->bQuitWhenDone;
+		Workload.Reset();
+		if (bQuit)
+		{
+			FPlatformMisc::RequestExit(false);
+		}
+		return false;
+	}
+
+	BeginStep(*Workload, *Component);
+	Workload->NextStepTime = Now + (Workload->Step == EStep::Expire ? TimerDuration + StepInterval : StepInterval);
+	return true;
+}
+
+void FDynamicTimersNetHarness::BeginStep(FWorkload& InWorkload, UDynamicTimersComponent& Component)
+{
+	InWorkload.StepStartBytes = DynamicTimers::GetNetTrafficCounters().BytesSent;
+
+	switch (InWorkload.Step)
+	{
+	case EStep::Register:
+	{
+		TArray<FBulkTimerRegistrationData> Registrations;
+		for (const FGameplayTag& TimerTag : InWorkload.TimerTags)
+		{
+			FBulkTimerRegistrationData& Registration = Registrations.AddDefaulted_GetRef();
+			Registration.TimerTag = TimerTag;
+			Registration.Duration = TimerDuration;
+		}
+		Component.RegisterGlobalTimers(Registrations);
+		break;
+	}
+	case EStep::Start:
+		Component.StartGlobalTimers(InWorkload.TagContainer);
+		break;
+	case EStep::Pause:
+		Component.PauseGlobalTimers(InWorkload.TagContainer);
+		break;
+	case EStep::Resume:
+		Component.ResumeGlobalTimers(InWorkload.TagContainer);
+		break;
+	default:
+		// Expire does nothing but wait for the timers to run out
+		break;
+	}
+}
+
+void FDynamicTimersNetHarness::EndStep(FWorkload& InWorkload, int32 NumConnections)
+{
+	if (InWorkload.Step == EStep::WaitForClients) return;
+
+	const uint64 NumBytes = DynamicTimers::GetNetTrafficCounters().BytesSent - InWorkload.StepStartBytes;
+	const double BytesPerTimer = static_cast<double>(NumBytes) / (InWorkload.TimerTags.Num() * FMath::Max(NumConnections, 1));
+	InWorkload.Csv += FString::Printf(TEXT("%d,%s,%d,%d,%llu,%.2f\n"), InWorkload.Cycle, GetStepName(InWorkload.Step),
+		InWorkload.TimerTags.Num(), NumConnections, NumBytes, BytesPerTimer);
+}
+
+void FDynamicTimersNetHarness::Listen(const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+{
+	if (Listener.IsValid())
+	{
+		Ar.Log(TEXT("DynamicTimers.NetHarness.Listen: already listening"));
+		return;
+	}
+
+	// Typically issued from -ExecCmds before the client has connected, so the component is looked for on every tick
+	Listener = MakeUnique<FListener>();
+	Listener->bQuitWhenDone = Args.Contains(TEXT("Quit"));
+	Listener->TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateStatic(&FDynamicTimersNetHarness::TickListener), 0.25f);
+	Listener->WorldCleanupHandle = FWorldDelegates::OnWorldCleanup.AddStatic(&FDynamicTimersNetHarness::HandleWorldCleanup);
+	Ar.Log(TEXT("DynamicTimers.NetHarness: listening for timer events"));
+}
+
+bool FDynamicTimersNetHarness::TickListener(float DeltaTime)
+{
+	if (Listener->Component.IsValid()) return true;
+
+	// The server destroys its harness component once the workload is done
+	if (Listener->Component.IsStale())
+	{
+		StopListening(*GLog);
+		return false;
+	}
+
+	for (const FWorldContext& Context : GEngine->GetWorldContexts())
+	{
+		UWorld* World = Context.World();
+		UDynamicTimersComponent* Component = World && World->GetNetMode() == NM_Client ? FindHarnessComponent(*World) : nullptr;
+		if (!Component) continue;
+
+		Listener->Component = Component;
+		Listener->StartBytesReceived = DynamicTimers::GetNetTrafficCounters().BytesReceived;
+		Listener->SubscriptionHandle = Component->SubscribeToTimer(FGameplayTag(), true, FDTTimerEventDelegate::CreateStatic(&FDynamicTimersNetHarness::HandleTimerEvent));
+		break;
+	}
+	return true;
+}
+
+void FDynamicTimersNetHarness::HandleTimerEvent(const FDTTimerEventData& EventData)
+{
+	UDynamicTimersComponent* Component = Listener->Component.Get();
+	if (!Component) return;
+
+	// Latencies are measured against the synced clock, so they include its residual offset like everything a player
+	// sees. The clock runs at the server's time dilation, so a dilated server adds no drift of its own.
+	const double ServerTime = Component->GetServerTime();
+	const FTimeData* TimerData = Component->FindTimer(EventData.TimerTag);
+
+	switch (EventData.Event)
+	{
+	case EDTTimerEvent::Started:
+	case EDTTimerEvent::Resumed:
+		if (TimerData && !TimerData->bLooping)
+		{
+			if (EventData.Event == EDTTimerEvent::Started)
+			{
+				Listener->StartLatencies.Add(ServerTime - TimerData->StartTime);
+			}
+			Listener->ExpectedFinishTimes.Add(EventData.TimerTag, TimerData->GetServerTimeAtElapsed(TimerData->Duration));
+		}
+		break;
+	case EDTTimerEvent::Paused:
+		Listener->ExpectedFinishTimes.Remove(EventData.TimerTag);
+		break;
+	case EDTTimerEvent::Finished:
+	{
+		double ExpectedFinishTime = 0.0;
+		if (Listener->ExpectedFinishTimes.RemoveAndCopyValue(EventData.TimerTag, ExpectedFinishTime))
+		{
+			Listener->FinishLatencies.Add(ServerTime - ExpectedFinishTime);
+		}
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+void FDynamicTimersNetHarness::HandleWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources)
+{
+	// Losing the server ends the run; reporting here lets a scripted client write its results and exit
+	const UDynamicTimersComponent* Component = Listener.IsValid() ? Listener->Component.Get() : nullptr;
+	if (Component && Component->GetWorld() == World)
+	{
+		StopListening(*GLog);
+	}
+}
+
+void FDynamicTimersNetHarness::Report(const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+{
+	if (!Listener.IsValid())
+	{
+		Ar.Log(TEXT("DynamicTimers.NetHarness.Report: not listening, run DynamicTimers.NetHarness.Listen first"));
+		return;
+	}
+	StopListening(Ar);
+}
+
+void FDynamicTimersNetHarness::StopListening(FOutputDevice& Ar)
+{
+	if (UDynamicTimersComponent* Component = Listener->Component.Get())
+	{
+		Component->UnsubscribeFromTimer(Listener->SubscriptionHandle);
+	}
+	FTSTicker::GetCoreTicker().RemoveTicker(Listener->TickerHandle);
+	FWorldDelegates::OnWorldCleanup.Remove(Listener->WorldCleanupHandle);
+
+	FString Csv = TEXT("Event,Samples,MinMs,MedianMs,P95Ms,MaxMs\n");
+	Csv += DescribeLatencies(TEXT("Started"), Listener->StartLatencies);
+	Csv += DescribeLatencies(TEXT("Finished"), Listener->FinishLatencies);
+	Csv += FString::Printf(TEXT("BytesReceived,%llu,-,-,-,-\n"), DynamicTimers::GetNetTrafficCounters().BytesReceived - Listener->StartBytesReceived);
+	WriteCsv(Csv, TEXT("NetLatency"), Ar);
+
+	const bool bQuit = Listener->bQuitWhenDone;
+	Listener.Reset();
+	if (bQuit)
+	{
+		FPlatformMisc::RequestExit(false);
+	}
+}
+
+UDynamicTimersComponent* FDynamicTimersNetHarness::SpawnHarnessComponent(UWorld& World)
+{
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.ObjectFlags |= RF_Transient;
+	AActor* Host = World.SpawnActor<AActor>(SpawnParameters);
+	if (!Host) return nullptr;
+
+	Host->bAlwaysRelevant = true;
+	Host->SetReplicates(true);
+
+	UDynamicTimersComponent* Component = NewObject<UDynamicTimersComponent>(Host);
+	Component->RegisterComponent();
+	return Component;
+}
+
+UDynamicTimersComponent* FDynamicTimersNetHarness::FindHarnessComponent(UWorld& World)
+{
+	// The harness's host is the one actor besides the game state that carries a timers component
+	const AGameStateBase* GameState = World.GetGameState();
+	for (TActorIterator<AActor> It(&World); It; ++It)
+	{
+		if (*It == GameState) continue;
+
+		if (UDynamicTimersComponent* Component = It->FindComponentByClass<UDynamicTimersComponent>())
+		{
+			return Component;
+		}
+	}
+	return nullptr;
+}
+
+FString FDynamicTimersNetHarness::DescribeLatencies(const TCHAR* Name, TArray<double>& Latencies)
+{
+	if (Latencies.IsEmpty())
+	{
+		return FString::Printf(TEXT("%s,0,-,-,-,-\n"), Name);
+	}
+
+	Latencies.Sort();
+	const auto Percentile = [&Latencies](double Fraction)
+	{
+		return Latencies[FMath::Min(FMath::FloorToInt32(Fraction * Latencies.Num()), Latencies.Num() - 1)] * 1000.0;
+	};
+	return FString::Printf(TEXT("%s,%d,%.1f,%.1f,%.1f,%.1f\n"), Name, Latencies.Num(), Latencies[0] * 1000.0, Percentile(0.5), Percentile(0.95), Latencies.Last() * 1000.0);
+}
+
+void FDynamicTimersNetHarness::WriteCsv(const FString& Csv, const TCHAR* Name, FOutputDevice& Ar)
+{
+	Ar.Log(Csv);
+
+	const FString CsvPath = FPaths::ProfilingDir() / TEXT("DynamicTimers") / FString::Printf(TEXT("%s-%s.csv"), Name, *FDateTime::Now().ToString());
+	if (FFileHelper::SaveStringToFile(Csv, *CsvPath))
+	{
+		Ar.Logf(TEXT("Wrote %s"), *CsvPath);
+	}
+}
+
+const TCHAR* FDynamicTimersNetHarness::GetStepName(EStep Step)
+{
+	switch (Step)
+	{
+	case EStep::Register: return TEXT("Register");
+	case EStep::Start: return TEXT("Start");
+	case EStep::Pause: return TEXT("Pause");
+	case EStep::Resume: return TEXT("Resume");
+	case EStep::Expire: return TEXT("Expire");
+	default: return TEXT("");
+	}
+}
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice DynamicTimersNetHarnessRunCommand(
+	TEXT("DynamicTimers.NetHarness.Run"),
+	TEXT("Server side of the net harness: waits for the clients, then registers, starts, pauses and resumes a set of timers on a replicated component of its own and lets them expire, once per cycle, and writes the bytes sent per step as CSV to the profiling directory. With 0 clients it also runs in a standalone world. Usage: DynamicTimers.NetHarness.Run [Clients] [Timers] [Cycles] [Quit]"),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateStatic(&FDynamicTimersNetHarness::RunWorkload));
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice DynamicTimersNetHarnessListenCommand(
+	TEXT("DynamicTimers.NetHarness.Listen"),
+	TEXT("Client side of the net harness: records the delay between the server's start and expiry of each timer and this client's OnTimerStarted and OnTimerFinished. Reports when the connection ends, or on DynamicTimers.NetHarness.Report. Usage: DynamicTimers.NetHarness.Listen [Quit]"),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateStatic(&FDynamicTimersNetHarness::Listen));
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice DynamicTimersNetHarnessReportCommand(
+	TEXT("DynamicTimers.NetHarness.Report"),
+	TEXT("Writes the latencies recorded by DynamicTimers.NetHarness.Listen as CSV to the profiling directory and stops recording."),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateStatic(&FDynamicTimersNetHarness::Report));
+
+#endif
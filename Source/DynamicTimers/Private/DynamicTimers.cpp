@@ -4,6 +4,23 @@
 
 #define LOCTEXT_NAMESPACE "FDynamicTimersModule"
 
+DEFINE_LOG_CATEGORY(LogDynamicTimers);
+
+DEFINE_STAT(STAT_DynamicTimers_ActiveTimers);
+DEFINE_STAT(STAT_DynamicTimers_PausedTimers);
+DEFINE_STAT(STAT_DynamicTimers_PendingTimers);
+DEFINE_STAT(STAT_DynamicTimers_Broadcasts);
+DEFINE_STAT(STAT_DynamicTimers_BytesSent);
+DEFINE_STAT(STAT_DynamicTimers_BytesReceived);
+
+#if !UE_BUILD_SHIPPING
+DynamicTimers::FNetTrafficCounters& DynamicTimers::GetNetTrafficCounters()
+{
+	static FNetTrafficCounters Counters;
+	return Counters;
+}
+#endif
+
 void FDynamicTimersModule::StartupModule()
 {
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
@@ -7,21 +7,17 @@
 
 FText UDynamicTimersFunctionLibrary::FormatTimeToString(float TotalSeconds)
 {
-	const float SafeTotalSeconds = FMath::Max(0.0f, TotalSeconds);
-
-	const int32 TotalSecondsInt = FMath::FloorToInt(SafeTotalSeconds);
-	const int32 Minutes = TotalSecondsInt / 60;
-	const int32 Seconds = TotalSecondsInt % 60;
-
-	FNumberFormattingOptions FormattingOptions;
-	FormattingOptions.MinimumIntegralDigits = 2;
-	FormattingOptions.MaximumIntegralDigits = 2;
+	return FDTTimeTextCache::FormatTime(TotalSeconds, EDTTimeFormat::MinutesSeconds);
+}
 
-	FFormatNamedArguments Args;
-	Args.Add(TEXT("Minutes"), FText::AsNumber(Minutes, &FormattingOptions));
-	Args.Add(TEXT("Seconds"), FText::AsNumber(Seconds, &FormattingOptions));
+FText UDynamicTimersFunctionLibrary::FormatTime(float TotalSeconds, EDTTimeFormat Format)
+{
+	return FDTTimeTextCache::FormatTime(TotalSeconds, Format);
+}
 
-	return FText::Format(NSLOCTEXT("MyGame", "TimeFormat", "{Minutes}:{Seconds}"), Args);
+FText UDynamicTimersFunctionLibrary::FormatTimeCached(FDTTimeTextCache& Cache, float TotalSeconds, EDTTimeFormat Format)
+{
+	return Cache.Update(TotalSeconds, Format);
 }
 
 UDynamicTimersComponent* UDynamicTimersFunctionLibrary::GetDynamicTimersComponent(const AGameStateBase* GameState)
@@ -0,0 +1,26 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Settings/DynamicTimersSettings.h"
+
+#include "Data/DynamicTimerCatalog.h"
+
+UDynamicTimersSettings::UDynamicTimersSettings()
+{
+	SectionName = TEXT("Dynamic Timers");
+}
+
+FName UDynamicTimersSettings::GetCategoryName() const
+{
+	return TEXT("Plugins");
+}
+
+const UDynamicTimerCatalog* UDynamicTimersSettings::GetTimerCatalog() const
+{
+	// Held by the settings object, which lives as long as the process
+	if (!LoadedTimerCatalog && !TimerCatalog.IsNull())
+	{
+		LoadedTimerCatalog = TimerCatalog.LoadSynchronous();
+	}
+	return LoadedTimerCatalog;
+}
@@ -0,0 +1,356 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Subsystems/DynamicTimersSubsystem.h"
+
+#include "DynamicTimers.h"
+#include "Components/DynamicActorTimersComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "Settings/DynamicTimersSettings.h"
+
+DECLARE_CYCLE_STAT(TEXT("Actor Timer Expiry"), STAT_DynamicTimers_ActorExpiry, STATGROUP_DynamicTimers);
+
+namespace DynamicTimersSubsystem
+{
+	// Deadline of timers that are not running
+	constexpr double NoDeadline = TNumericLimits<double>::Max();
+
+	// Stale heap entries allowed beyond one per timer before the heap is rebuilt from the live deadlines
+	constexpr int32 DeadlineHeapSlack = 64;
+}
+
+void UDynamicTimersSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	ActorDestroyedHandle = GetWorld()->AddOnActorDestroyedHandler(FOnActorDestroyed::FDelegate::CreateUObject(this, &UDynamicTimersSubsystem::HandleActorDestroyed));
+
+	// Loads the timer catalog with the world rather than on the first replicated timer that needs it
+	GetDefault<UDynamicTimersSettings>()->GetTimerCatalog();
+}
+
+void UDynamicTimersSubsystem::Deinitialize()
+{
+	GetWorld()->RemoveOnActorDestroyededHandler(ActorDestroyedHandle);
+	ActorDestroyedHandle.Reset();
+
+	Super::Deinitialize();
+}
+
+bool UDynamicTimersSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UDynamicTimersSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UDynamicTimersSubsystem, STATGROUP_Tickables);
+}
+
+void UDynamicTimersSubsystem::Tick(float DeltaTime)
+{
+	const double CurrentTime = GetCurrentTime();
+	if (DeadlineHeap.IsEmpty() || DeadlineHeap.HeapTop().Deadline > CurrentTime) return;
+
+	TRACE_CPUPROFILER_EVENT_SCOPE(UDynamicTimersSubsystem::Tick);
+	SCOPE_CYCLE_COUNTER(STAT_DynamicTimers_ActorExpiry);
+
+	ExpiredTimers.Reset();
+	while (!DeadlineHeap.IsEmpty() && DeadlineHeap.HeapTop().Deadline <= CurrentTime)
+	{
+		FDeadlineEntry Entry;
+		DeadlineHeap.HeapPop(Entry, EAllowShrinking::No);
+
+		// Left behind by a timer that was rescheduled, paused or removed since
+		const int32* FoundIndex = IndexByKey.Find(Entry.Key);
+		if (!FoundIndex || Deadlines[*FoundIndex] != Entry.Deadline) continue;
+
+		const int32 Index = *FoundIndex;
+
+		ExpiredTimers.Emplace(Keys[Index], Durations[Index]);
+		RemoveTimerAt(Index);
+	}
+
+	// Listeners may register timers again (e.g. a repeating ability), the storage is settled by now
+	for (const TPair<FActorTimerKey, float>& ExpiredTimer : ExpiredTimers)
+	{
+		NotifyTimerRemoved(ExpiredTimer.Key, ExpiredTimer.Value);
+	}
+}
+
+void UDynamicTimersSubsystem::RegisterActorTimer(AActor* Actor, FGameplayTag TimerTag, float Duration, bool bStart)
+{
+	// Quantized like every replicated time, so bridged clients count down from the same numbers
+	Duration = DynamicTimers::QuantizeNetTime(Duration);
+	if (!Actor || !TimerTag.IsValid() || Duration <= 0.0f) return;
+
+	int32 Index = FindTimerIndex(Actor, TimerTag);
+	const bool bIsNewTimer = Index == INDEX_NONE;
+	const bool bRestarted = bStart && !bIsNewTimer && (Flags[Index] & Flag_Started);
+	if (bIsNewTimer)
+	{
+		Index = Keys.Add({ Actor, TimerTag });
+		Deadlines.Add(DynamicTimersSubsystem::NoDeadline);
+		Durations.Add(0.0f);
+		RemainingTimes.Add(0.0f);
+		Flags.Add(0);
+		IndexByKey.Add(Keys[Index], Index);
+		++NumTimersByActor.FindOrAdd(Actor);
+	}
+
+	Durations[Index] = Duration;
+	RemainingTimes[Index] = Duration;
+	Flags[Index] = bStart ? Flag_Started : 0;
+	Deadlines[Index] = DynamicTimersSubsystem::NoDeadline;
+	if (bStart)
+	{
+		SetDeadline(Index, GetCurrentTime() + Duration);
+	}
+
+	if (bIsNewTimer)
+	{
+		NotifyTimerChanged(Index, EDTTimerEvent::Registered);
+	}
+	if (bStart)
+	{
+		NotifyTimerChanged(Index, EDTTimerEvent::Started);
+	}
+	UpdateBridge(Index, bRestarted);
+}
+
+bool UDynamicTimersSubsystem::StartActorTimer(AActor* Actor, FGameplayTag TimerTag)
+{
+	const int32 Index = FindTimerIndex(Actor, TimerTag);
+	if (Index == INDEX_NONE || (Flags[Index] & Flag_Started)) return false;
+
+	Flags[Index] |= Flag_Started;
+	SetDeadline(Index, GetCurrentTime() + RemainingTimes[Index]);
+
+	NotifyTimerChanged(Index, EDTTimerEvent::Started);
+	UpdateBridge(Index);
+	return true;
+}
+
+bool UDynamicTimersSubsystem::PauseActorTimer(AActor* Actor, FGameplayTag TimerTag)
+{
+	const int32 Index = FindTimerIndex(Actor, TimerTag);
+	if (Index == INDEX_NONE || !IsRunning(Index)) return false;
+
+	RemainingTimes[Index] = DynamicTimers::QuantizeNetTime(GetRemainingTime(Index, GetCurrentTime()));
+	Flags[Index] |= Flag_Paused;
+	Deadlines[Index] = DynamicTimersSubsystem::NoDeadline;
+
+	NotifyTimerChanged(Index, EDTTimerEvent::Paused);
+	UpdateBridge(Index);
+	return true;
+}
+
+bool UDynamicTimersSubsystem::ResumeActorTimer(AActor* Actor, FGameplayTag TimerTag)
+{
+	const int32 Index = FindTimerIndex(Actor, TimerTag);
+	if (Index == INDEX_NONE || !(Flags[Index] & Flag_Paused)) return false;
+
+	Flags[Index] &= ~Flag_Paused;
+	SetDeadline(Index, GetCurrentTime() + RemainingTimes[Index]);
+
+	NotifyTimerChanged(Index, EDTTimerEvent::Resumed);
+	UpdateBridge(Index);
+	return true;
+}
+
+bool UDynamicTimersSubsystem::RemoveActorTimer(AActor* Actor, FGameplayTag TimerTag)
+{
+	const int32 Index = FindTimerIndex(Actor, TimerTag);
+	if (Index == INDEX_NONE) return false;
+
+	const FActorTimerKey Key = Keys[Index];
+	const float Duration = Durations[Index];
+	RemoveTimerAt(Index);
+	NotifyTimerRemoved(Key, Duration);
+	return true;
+}
+
+int32 UDynamicTimersSubsystem::RemoveActorTimers(AActor* Actor)
+{
+	const TObjectKey<AActor> ActorKey(Actor);
+	if (!NumTimersByActor.Contains(ActorKey)) return 0;
+
+	// Walking down means the timer swapped into a freed slot has already been looked at
+	TArray<TPair<FActorTimerKey, float>, TInlineAllocator<8>> RemovedTimers;
+	for (int32 Index = Keys.Num() - 1; Index >= 0; --Index)
+	{
+		if (Keys[Index].Actor == ActorKey)
+		{
+			RemovedTimers.Emplace(Keys[Index], Durations[Index]);
+			RemoveTimerAt(Index);
+		}
+	}
+
+	for (const TPair<FActorTimerKey, float>& RemovedTimer : RemovedTimers)
+	{
+		NotifyTimerRemoved(RemovedTimer.Key, RemovedTimer.Value);
+	}
+	return RemovedTimers.Num();
+}
+
+bool UDynamicTimersSubsystem::GetActorTimerRemainingTime(AActor* Actor, FGameplayTag TimerTag, float& RemainingTime) const
+{
+	const int32 Index = FindTimerIndex(Actor, TimerTag);
+	RemainingTime = Index != INDEX_NONE ? GetRemainingTime(Index, GetCurrentTime()) : 0.0f;
+	return Index != INDEX_NONE;
+}
+
+bool UDynamicTimersSubsystem::IsActorTimerRunning(AActor* Actor, FGameplayTag TimerTag) const
+{
+	const int32 Index = FindTimerIndex(Actor, TimerTag);
+	return Index != INDEX_NONE && IsRunning(Index);
+}
+
+int32 UDynamicTimersSubsystem::FindTimerIndex(AActor* Actor, const FGameplayTag& TimerTag) const
+{
+	const int32* Index = IndexByKey.Find({ Actor, TimerTag });
+	return Index ? *Index : INDEX_NONE;
+}
+
+void UDynamicTimersSubsystem::RemoveTimerAt(int32 Index)
+{
+	IndexByKey.Remove(Keys[Index]);
+
+	int32& NumActorTimers = NumTimersByActor.FindChecked(Keys[Index].Actor);
+	if (--NumActorTimers == 0)
+	{
+		NumTimersByActor.Remove(Keys[Index].Actor);
+	}
+
+	// Every array swaps the same way, so slots stay aligned and only the moved timer's index changes
+	Keys.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Deadlines.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Durations.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	RemainingTimes.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Flags.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+
+	if (Keys.IsValidIndex(Index))
+	{
+		IndexByKey.Add(Keys[Index], Index);
+	}
+}
+
+float UDynamicTimersSubsystem::GetRemainingTime(int32 Index, double CurrentTime) const
+{
+	return IsRunning(Index)
+		? FMath::Max(0.0f, static_cast<float>(Deadlines[Index] - CurrentTime))
+		: RemainingTimes[Index];
+}
+
+void UDynamicTimersSubsystem::SetDeadline(int32 Index, double Deadline)
+{
+	Deadline = DynamicTimers::QuantizeNetTime(Deadline);
+	Deadlines[Index] = Deadline;
+	DeadlineHeap.HeapPush({ Deadline, Keys[Index] });
+
+	// Stale entries only go once they reach the top, a long deadline rescheduled often would pile them up
+	if (DeadlineHeap.Num() > 2 * Keys.Num() + DynamicTimersSubsystem::DeadlineHeapSlack)
+	{
+		RebuildDeadlineHeap();
+	}
+}
+
+void UDynamicTimersSubsystem::RebuildDeadlineHeap()
+{
+	DeadlineHeap.Reset();
+	for (int32 Index = 0; Index < Keys.Num(); ++Index)
+	{
+		if (Deadlines[Index] != DynamicTimersSubsystem::NoDeadline)
+		{
+			DeadlineHeap.Add({ Deadlines[Index], Keys[Index] });
+		}
+	}
+	DeadlineHeap.Heapify();
+}
+
+double UDynamicTimersSubsystem::GetCurrentTime() const
+{
+	return GetWorld()->GetTimeSeconds();
+}
+
+void UDynamicTimersSubsystem::HandleActorDestroyed(AActor* Actor)
+{
+	RemoveActorTimers(Actor);
+}
+
+void UDynamicTimersSubsystem::NotifyTimerChanged(int32 Index, EDTTimerEvent Event)
+{
+	OnActorTimerEvent.Broadcast(Keys[Index].Actor.ResolveObjectPtr(), { Event, Keys[Index].TimerTag, Durations[Index], FGameplayTag(), INDEX_NONE });
+}
+
+void UDynamicTimersSubsystem::NotifyTimerRemoved(const FActorTimerKey& Key, float Duration)
+{
+	AActor* Actor = Key.Actor.ResolveObjectPtr();
+
+	if (const TWeakObjectPtr<UDynamicActorTimersComponent>* Bridge = BridgesByActor.Find(Key.Actor))
+	{
+		if (UDynamicActorTimersComponent* BridgeComponent = Bridge->Get())
+		{
+			BridgeComponent->RemoveTimer(Key.TimerTag);
+		}
+	}
+
+	OnActorTimerEvent.Broadcast(Actor, { EDTTimerEvent::Finished, Key.TimerTag, Duration, FGameplayTag(), INDEX_NONE });
+	OnActorTimerFinished.Broadcast(Actor, Key.TimerTag);
+}
+
+void UDynamicTimersSubsystem::UpdateBridge(int32 Index, bool bRestarted)
+{
+	if (BridgesByActor.IsEmpty()) return;
+
+	if (const TWeakObjectPtr<UDynamicActorTimersComponent>* Bridge = BridgesByActor.Find(Keys[Index].Actor))
+	{
+		if (UDynamicActorTimersComponent* BridgeComponent = Bridge->Get())
+		{
+			BridgeComponent->UpsertTimer(MakeTimerData(Index), bRestarted);
+		}
+	}
+}
+
+FTimeData UDynamicTimersSubsystem::MakeTimerData(int32 Index) const
+{
+	// The same server time based model the game state's timers use, so clients evaluate it the same way
+	FTimeData TimerData;
+	TimerData.TimerTag = Keys[Index].TimerTag;
+	TimerData.Duration = Durations[Index];
+	TimerData.bIsStarted = (Flags[Index] & Flag_Started) != 0;
+	TimerData.bIsPaused = (Flags[Index] & Flag_Paused) != 0;
+	if (IsRunning(Index))
+	{
+		TimerData.StartTime = Deadlines[Index] - Durations[Index];
+	}
+	else if (TimerData.bIsPaused)
+	{
+		TimerData.ElapsedTimeWhenPaused = Durations[Index] - RemainingTimes[Index];
+	}
+	return TimerData;
+}
+
+void UDynamicTimersSubsystem::AddBridge(UDynamicActorTimersComponent& Bridge)
+{
+	const TObjectKey<AActor> ActorKey(Bridge.GetOwner());
+	BridgesByActor.Add(ActorKey, &Bridge);
+
+	// Timers the actor got before its component began play
+	if (NumTimersByActor.Contains(ActorKey))
+	{
+		for (int32 Index = 0; Index < Keys.Num(); ++Index)
+		{
+			if (Keys[Index].Actor == ActorKey)
+			{
+				Bridge.UpsertTimer(MakeTimerData(Index));
+			}
+		}
+	}
+}
+
+void UDynamicTimersSubsystem::RemoveBridge(UDynamicActorTimersComponent& Bridge)
+{
+	BridgesByActor.Remove(Bridge.GetOwner());
+}
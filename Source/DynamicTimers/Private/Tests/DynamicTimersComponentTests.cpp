@@ -0,0 +1,353 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "NativeGameplayTags.h"
+#include "Components/DynamicTimersComponent.h"
+#include "Components/DynamicTimersPlayerComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/Actor.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/WorldSettings.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/App.h"
+#include "Misc/AutomationTest.h"
+#include "Serialization/BitReader.h"
+#include "Serialization/BitWriter.h"
+
+UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_DynamicTimersTest_Round, "DynamicTimers.Test.Round");
+UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_DynamicTimersTest_Cooldown, "DynamicTimers.Test.Cooldown");
+UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_DynamicTimersTest_Respawn, "DynamicTimers.Test.Respawn");
+
+namespace DynamicTimersTests
+{
+	// Slack for times that went through the net quantization and whole frames of world time
+	constexpr float TimeTolerance = 0.05f;
+
+	/**
+	 * A standalone game world holding one timers component on a plain actor, advanced by hand.
+	 * Records every event the component broadcasts. Needs no map, so it runs headless with -nullrhi.
+	 */
+	struct FTestWorld
+	{
+		FTestWorld()
+		{
+			World = UWorld::CreateWorld(EWorldType::Game, false);
+			GEngine->CreateNewWorldContext(EWorldType::Game).SetCurrentWorld(World);
+			World->InitializeActorsForPlay(FURL());
+			World->BeginPlay();
+
+			// Without a game mode nothing else starts play, and components would never see BeginPlay
+			if (!World->HasBegunPlay())
+			{
+				World->GetWorldSettings()->NotifyBeginPlay();
+			}
+
+			Host = World->SpawnActor<AActor>();
+			Component = NewObject<UDynamicTimersComponent>(Host);
+			Component->RegisterComponent();
+			Component->SubscribeToTimer(FGameplayTag(), true, FDTTimerEventDelegate::CreateLambda([this](const FDTTimerEventData& EventData)
+			{
+				Events.Add(EventData);
+			}));
+		}
+
+		~FTestWorld()
+		{
+			// Ends play first, which lets go of the engine timers and world delegates the component holds
+			Host->Destroy();
+			GEngine->DestroyWorldContext(World);
+			World->DestroyWorld(false);
+		}
+
+		UE_NONCOPYABLE(FTestWorld);
+
+		// Advances world time frame by frame; the engine timers behind expiry only run once per frame counter
+		void Tick(float Seconds)
+		{
+			constexpr float FrameTime = 0.05f;
+			for (float Remaining = Seconds; Remaining > UE_KINDA_SMALL_NUMBER; Remaining -= FrameTime)
+			{
+				++GFrameCounter;
+				World->Tick(LEVELTICK_All, FMath::Min(Remaining, FrameTime));
+			}
+		}
+
+		// Removes the first recorded event of the kind, so the same broadcast is not counted twice
+		bool TakeEvent(EDTTimerEvent Event, const FGameplayTag& TimerTag)
+		{
+			const int32 Index = Events.IndexOfByPredicate([Event, &TimerTag](const FDTTimerEventData& EventData)
+			{
+				return EventData.Event == Event && EventData.TimerTag == TimerTag;
+			});
+
+			if (Index == INDEX_NONE) return false;
+
+			Events.RemoveAt(Index);
+			return true;
+		}
+
+		int32 CountTimersComponents() const
+		{
+			int32 NumComponents = 0;
+			for (TActorIterator<AActor> It(World); It; ++It)
+			{
+				NumComponents += It->FindComponentByClass<UDynamicTimersComponent>() != nullptr;
+			}
+			return NumComponents;
+		}
+
+		UWorld* World = nullptr;
+		AActor* Host = nullptr;
+		UDynamicTimersComponent* Component = nullptr;
+		TArray<FDTTimerEventData> Events;
+	};
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDynamicTimersLifecycleTest, "DynamicTimers.Component.Lifecycle",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FDynamicTimersLifecycleTest::RunTest(const FString& Parameters)
+{
+	using namespace DynamicTimersTests;
+
+	FTestWorld TestWorld;
+	UDynamicTimersComponent& Component = *TestWorld.Component;
+	const FGameplayTag TimerTag = TAG_DynamicTimersTest_Round;
+	float RemainingTime = 0.0f;
+
+	Component.RegisterTimer(TimerTag, 10.0f);
+	TestWorld.Tick(0.1f);
+	TestTrue(TEXT("Registering fires OnTimerRegistered"), TestWorld.TakeEvent(EDTTimerEvent::Registered, TimerTag));
+	TestTrue(TEXT("A registered timer can be queried"), Component.GetTimerRemainingTime(TimerTag, RemainingTime));
+	TestEqual(TEXT("A timer that has not started keeps its duration"), RemainingTime, 10.0f, TimeTolerance);
+
+	Component.StartGlobalTimer(TimerTag);
+	TestWorld.Tick(2.0f);
+	TestTrue(TEXT("Starting fires OnTimerStarted"), TestWorld.TakeEvent(EDTTimerEvent::Started, TimerTag));
+	Component.GetTimerRemainingTime(TimerTag, RemainingTime);
+	TestEqual(TEXT("A started timer counts down with world time"), RemainingTime, 8.0f, TimeTolerance);
+
+	Component.PauseGlobalTimer(TimerTag);
+	TestWorld.Tick(0.1f);
+	TestTrue(TEXT("Pausing fires OnTimerPaused"), TestWorld.TakeEvent(EDTTimerEvent::Paused, TimerTag));
+	float PausedRemainingTime = 0.0f;
+	Component.GetTimerRemainingTime(TimerTag, PausedRemainingTime);
+	TestWorld.Tick(3.0f);
+	Component.GetTimerRemainingTime(TimerTag, RemainingTime);
+	TestEqual(TEXT("A paused timer does not count down"), RemainingTime, PausedRemainingTime, TimeTolerance);
+
+	Component.ResumeGlobalTimer(TimerTag);
+	TestWorld.Tick(1.0f);
+	TestTrue(TEXT("Resuming fires OnTimerResumed"), TestWorld.TakeEvent(EDTTimerEvent::Resumed, TimerTag));
+	Component.GetTimerRemainingTime(TimerTag, RemainingTime);
+	TestEqual(TEXT("A resumed timer carries on from where it was paused"), RemainingTime, PausedRemainingTime - 1.0f, TimeTolerance);
+
+	Component.RemoveGlobalTimer(TimerTag);
+	TestWorld.Tick(0.1f);
+	TestTrue(TEXT("Removing fires OnTimerFinished"), TestWorld.TakeEvent(EDTTimerEvent::Finished, TimerTag));
+	TestFalse(TEXT("A removed timer is gone"), Component.GetTimerRemainingTime(TimerTag, RemainingTime));
+	TestEqual(TEXT("No other events fired"), TestWorld.Events.Num(), 0);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDynamicTimersExpiryTest, "DynamicTimers.Component.Expiry",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FDynamicTimersExpiryTest::RunTest(const FString& Parameters)
+{
+	using namespace DynamicTimersTests;
+
+	FTestWorld TestWorld;
+	UDynamicTimersComponent& Component = *TestWorld.Component;
+	const FGameplayTag TimerTag = TAG_DynamicTimersTest_Round;
+	float RemainingTime = 0.0f;
+
+	Component.RegisterTimer(TimerTag, 1.0f);
+	Component.StartGlobalTimer(TimerTag);
+	TestWorld.Tick(0.5f);
+	TestTrue(TEXT("A running timer exists before its deadline"), Component.GetTimerRemainingTime(TimerTag, RemainingTime));
+	TestFalse(TEXT("Nothing finishes before the deadline"), TestWorld.TakeEvent(EDTTimerEvent::Finished, TimerTag));
+
+	TestWorld.Tick(1.0f);
+	TestTrue(TEXT("Reaching the deadline fires OnTimerFinished"), TestWorld.TakeEvent(EDTTimerEvent::Finished, TimerTag));
+	TestFalse(TEXT("An expired timer is removed"), Component.GetTimerRemainingTime(TimerTag, RemainingTime));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDynamicTimersStaleExpiryTest, "DynamicTimers.Component.StaleExpiry",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FDynamicTimersStaleExpiryTest::RunTest(const FString& Parameters)
+{
+	using namespace DynamicTimersTests;
+
+	FTestWorld TestWorld;
+	UDynamicTimersComponent& Component = *TestWorld.Component;
+	const FGameplayTag TimerTag = TAG_DynamicTimersTest_Round;
+	float RemainingTime = 0.0f;
+
+	Component.RegisterTimer(TimerTag, 1.0f);
+	Component.StartGlobalTimer(TimerTag);
+	TestWorld.Tick(0.5f);
+
+	// The same tag registered again must not be finished by the deadline of the timer it replaced
+	Component.RemoveGlobalTimer(TimerTag);
+	Component.RegisterTimer(TimerTag, 3.0f);
+	Component.StartGlobalTimer(TimerTag);
+	TestWorld.Tick(0.1f);
+	TestTrue(TEXT("Removing the first timer fires OnTimerFinished"), TestWorld.TakeEvent(EDTTimerEvent::Finished, TimerTag));
+
+	TestWorld.Tick(1.0f);
+	TestTrue(TEXT("The new timer outlives the old deadline"), Component.GetTimerRemainingTime(TimerTag, RemainingTime));
+	TestFalse(TEXT("The old deadline finishes nothing"), TestWorld.TakeEvent(EDTTimerEvent::Finished, TimerTag));
+	TestEqual(TEXT("The new timer counts down from its own start"), RemainingTime, 1.9f, TimeTolerance);
+
+	TestWorld.Tick(2.0f);
+	TestTrue(TEXT("The new timer finishes at its own deadline"), TestWorld.TakeEvent(EDTTimerEvent::Finished, TimerTag));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDynamicTimersSnapshotRestoreTest, "DynamicTimers.Component.SnapshotRestore",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FDynamicTimersSnapshotRestoreTest::RunTest(const FString& Parameters)
+{
+	using namespace DynamicTimersTests;
+
+	FTestWorld TestWorld;
+	UDynamicTimersComponent& Component = *TestWorld.Component;
+	float RemainingTime = 0.0f;
+
+	Component.RegisterTimer(TAG_DynamicTimersTest_Round, 10.0f);
+	Component.RegisterTimer(TAG_DynamicTimersTest_Cooldown, 5.0f);
+	Component.StartGlobalTimer(TAG_DynamicTimersTest_Round);
+	TestWorld.Tick(1.0f);
+
+	TArray<uint8> Snapshot;
+	Component.ExportTimerSnapshot(Snapshot);
+
+	Component.RemoveGlobalTimer(TAG_DynamicTimersTest_Cooldown);
+	Component.RegisterTimer(TAG_DynamicTimersTest_Respawn, 3.0f);
+	TestWorld.Tick(2.0f);
+	TestWorld.Events.Reset();
+
+	TestTrue(TEXT("The snapshot is restored"), Component.RestoreTimerSnapshot(Snapshot));
+	TestWorld.Tick(0.1f);
+
+	// Only the timers that differ from the snapshot come and go
+	TestFalse(TEXT("A timer the snapshot also holds does not finish"), TestWorld.TakeEvent(EDTTimerEvent::Finished, TAG_DynamicTimersTest_Round));
+	TestFalse(TEXT("A timer the snapshot also holds is not registered again"), TestWorld.TakeEvent(EDTTimerEvent::Registered, TAG_DynamicTimersTest_Round));
+	TestTrue(TEXT("A timer the snapshot lacks finishes"), TestWorld.TakeEvent(EDTTimerEvent::Finished, TAG_DynamicTimersTest_Respawn));
+	TestTrue(TEXT("A timer only the snapshot holds is registered"), TestWorld.TakeEvent(EDTTimerEvent::Registered, TAG_DynamicTimersTest_Cooldown));
+
+	Component.GetTimerRemainingTime(TAG_DynamicTimersTest_Round, RemainingTime);
+	TestEqual(TEXT("The restored timer carries on from its exported elapsed time"), RemainingTime, 8.9f, TimeTolerance);
+	TestFalse(TEXT("A timer the snapshot lacks is gone"), Component.GetTimerRemainingTime(TAG_DynamicTimersTest_Respawn, RemainingTime));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDynamicTimersPredictionTest, "DynamicTimers.Component.Prediction",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FDynamicTimersPredictionTest::RunTest(const FString& Parameters)
+{
+	using namespace DynamicTimersTests;
+
+	FTestWorld TestWorld;
+	UWorld* World = TestWorld.World;
+	const FGameplayTag TimerTag = TAG_DynamicTimersTest_Cooldown;
+
+	// The client's side: a game state it has no authority over, and its own player controller
+	AGameStateBase* GameState = World->SpawnActor<AGameStateBase>();
+	World->SetGameState(GameState);
+	GameState->SetRole(ROLE_SimulatedProxy);
+	UDynamicTimersComponent* ClientComponent = NewObject<UDynamicTimersComponent>(GameState);
+	ClientComponent->RegisterComponent();
+	ClientComponent->SubscribeToTimer(FGameplayTag(), true, FDTTimerEventDelegate::CreateLambda([&TestWorld](const FDTTimerEventData& EventData)
+	{
+		TestWorld.Events.Add(EventData);
+	}));
+
+	APlayerController* PlayerController = World->SpawnActor<APlayerController>();
+	UDynamicTimersPlayerComponent* PlayerComponent = NewObject<UDynamicTimersPlayerComponent>(PlayerController);
+	PlayerComponent->RegisterComponent();
+
+	// A player timer as the server writes it into the player's relevant timers
+	FTimeData ServerTimer;
+	ServerTimer.TimerTag = TimerTag;
+	ServerTimer.Duration = 10.0f;
+	ServerTimer.bIsStarted = true;
+	ServerTimer.StartTime = World->GetTimeSeconds();
+	ServerTimer.Scope = EDTTimerScope::Player;
+
+	FBitWriter Writer(0, true);
+	bool bSerialized = false;
+	ServerTimer.NetSerialize(Writer, nullptr, bSerialized);
+
+	FBitReader Reader(Writer.GetData(), Writer.GetNumBits());
+	FTimeData& ReceivedTimer = PlayerComponent->RelevantTimers.Items.AddDefaulted_GetRef();
+	ReceivedTimer.NetSerialize(Reader, nullptr, bSerialized);
+	TestTrue(TEXT("Player scope survives replication"), ReceivedTimer.Scope == EDTTimerScope::Player);
+
+	// Tags need a package map, or fast replication, to travel through a bare bit archive
+	ReceivedTimer.TimerTag = TimerTag;
+	ReceivedTimer.PostReplicatedAdd(PlayerComponent->RelevantTimers);
+	PlayerComponent->HandleRelevantTimersReceived();
+	TestWorld.Events.Reset();
+
+	// With no net driver the server RPC runs in place. This world has no server timer to apply it to,
+	// so the refusal coming back proves the prediction was sent.
+	TestTrue(TEXT("The player's own timer can be predicted"), ClientComponent->PredictTimerOperation(TimerTag, EDTTimerOperation::Pause));
+	TestTrue(TEXT("The prediction fires OnTimerPaused at once"), TestWorld.TakeEvent(EDTTimerEvent::Paused, TimerTag));
+	TestTrue(TEXT("The server refuses the prediction, which resumes the timer"), TestWorld.TakeEvent(EDTTimerEvent::Resumed, TimerTag));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDynamicTimersNetHarnessTest, "DynamicTimers.NetHarness.Workload",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FDynamicTimersNetHarnessTest::RunTest(const FString& Parameters)
+{
+	using namespace DynamicTimersTests;
+
+	// Without clients the workload runs every step in a standalone world. Nothing goes on the wire, so this covers
+	// the step sequence and the harness's own component, not the traffic a real server and client measure.
+	const TSharedRef<FTestWorld> TestWorld = MakeShared<FTestWorld>();
+	IConsoleManager::Get().ProcessUserConsoleInput(TEXT("DynamicTimers.NetHarness.Run 0 3 1"), *GLog, TestWorld->World);
+	TestEqual(TEXT("The harness runs on a timers component of its own"), TestWorld->CountTimersComponents(), 2);
+
+	// A cycle takes a few seconds of real time, the harness paces its steps by the platform clock
+	const double Deadline = FPlatformTime::Seconds() + 30.0;
+	double LastWorldTime = -1.0;
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, TestWorld, Deadline, LastWorldTime]() mutable
+	{
+		// Game builds tick every world context themselves, the editor does not
+		UWorld* World = TestWorld->World;
+		if (World->GetTimeSeconds() == LastWorldTime)
+		{
+			World->Tick(LEVELTICK_All, FApp::GetDeltaTime());
+		}
+		LastWorldTime = World->GetTimeSeconds();
+
+		const bool bFinished = TestWorld->CountTimersComponents() == 1;
+		if (!bFinished && FPlatformTime::Seconds() < Deadline) return false;
+
+		TestTrue(TEXT("The workload finishes and removes its timers component"), bFinished);
+		return true;
+	}));
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,132 @@
+#include "Types/DTDeadlineQueue.h"
+
+void FDTDeadlineQueue::Schedule(const FGameplayTag& TimerTag, double Deadline)
+{
+	if (const int32* Position = PositionByTag.Find(TimerTag))
+	{
+		const int32 Index = *Position;
+		const double OldDeadline = Heap[Index].Deadline;
+		Heap[Index].Deadline = Deadline;
+		if (Deadline < OldDeadline)
+		{
+			SiftUp(Index);
+		}
+		else
+		{
+			SiftDown(Index);
+		}
+		return;
+	}
+
+	const int32 Index = Heap.Add({ Deadline, TimerTag });
+	PositionByTag.Add(TimerTag, Index);
+	SiftUp(Index);
+}
+
+bool FDTDeadlineQueue::Cancel(const FGameplayTag& TimerTag)
+{
+	if (const int32* Position = PositionByTag.Find(TimerTag))
+	{
+		RemoveAt(*Position);
+		return true;
+	}
+	return false;
+}
+
+void FDTDeadlineQueue::PopExpired(double Now, TArray<FGameplayTag>& OutExpired)
+{
+	while (!Heap.IsEmpty() && Heap[0].Deadline <= Now)
+	{
+		OutExpired.Add(Heap[0].TimerTag);
+		RemoveAt(0);
+	}
+}
+
+void FDTDeadlineQueue::Reset()
+{
+	Heap.Reset();
+	PositionByTag.Reset();
+}
+
+void FDTDeadlineQueue::AddUnordered(const FGameplayTag& TimerTag, double Deadline)
+{
+	check(!PositionByTag.Contains(TimerTag));
+	PositionByTag.Add(TimerTag, Heap.Add({ Deadline, TimerTag }));
+}
+
+void FDTDeadlineQueue::Heapify()
+{
+	for (int32 Index = Heap.Num() / 2 - 1; Index >= 0; --Index)
+	{
+		SiftDown(Index);
+	}
+}
+
+void FDTDeadlineQueue::SiftUp(int32 Index)
+{
+	while (Index > 0)
+	{
+		const int32 Parent = (Index - 1) / 2;
+		if (Heap[Parent].Deadline <= Heap[Index].Deadline)
+		{
+			break;
+		}
+		SwapEntries(Parent, Index);
+		Index = Parent;
+	}
+}
+
+void FDTDeadlineQueue::SiftDown(int32 Index)
+{
+	const int32 Count = Heap.Num();
+	for (;;)
+	{
+		const int32 Left = Index * 2 + 1;
+		const int32 Right = Left + 1;
+		int32 Smallest = Index;
+
+		if (Left < Count && Heap[Left].Deadline < Heap[Smallest].Deadline)
+		{
+			Smallest = Left;
+		}
+		if (Right < Count && Heap[Right].Deadline < Heap[Smallest].Deadline)
+		{
+			Smallest = Right;
+		}
+		if (Smallest == Index)
+		{
+			break;
+		}
+		SwapEntries(Index, Smallest);
+		Index = Smallest;
+	}
+}
+
+void FDTDeadlineQueue::SwapEntries(int32 A, int32 B)
+{
+	Heap.Swap(A, B);
+	PositionByTag[Heap[A].TimerTag] = A;
+	PositionByTag[Heap[B].TimerTag] = B;
+}
+
+void FDTDeadlineQueue::RemoveAt(int32 Index)
+{
+	PositionByTag.Remove(Heap[Index].TimerTag);
+
+	const int32 LastIndex = Heap.Num() - 1;
+	if (Index != LastIndex)
+	{
+		const FGameplayTag MovedTag = Heap[LastIndex].TimerTag;
+		Heap[Index] = Heap[LastIndex];
+		PositionByTag[MovedTag] = Index;
+		Heap.RemoveAt(LastIndex, 1, EAllowShrinking::No);
+
+		// The moved entry can belong either above or below its new slot
+		SiftUp(Index);
+		SiftDown(PositionByTag[MovedTag]);
+	}
+	else
+	{
+		Heap.RemoveAt(LastIndex, 1, EAllowShrinking::No);
+	}
+}
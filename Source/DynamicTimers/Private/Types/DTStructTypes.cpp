@@ -0,0 +1,536 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Types/DTStructTypes.h"
+
+#include "DynamicTimers.h"
+#include "Components/DynamicActorTimersComponent.h"
+#include "Components/DynamicTimersComponent.h"
+#include "Components/DynamicTimersPlayerComponent.h"
+#include "Data/DynamicTimerCatalog.h"
+#include "Settings/DynamicTimersSettings.h"
+
+DECLARE_CYCLE_STAT(TEXT("Replication Receive"), STAT_DynamicTimers_Receive, STATGROUP_DynamicTimers);
+
+namespace DynamicTimers
+{
+	enum ETimeDataNetFlags : uint16
+	{
+		NetFlag_Started = 1 << 0,
+		NetFlag_Paused = 1 << 1,
+		NetFlag_Looping = 1 << 2,
+		NetFlag_Phases = 1 << 3,
+		NetFlag_Rate = 1 << 4,
+		NetFlag_Prediction = 1 << 5,
+		NetFlag_Thresholds = 1 << 6,
+		NetFlag_Definition = 1 << 7,
+		NetFlag_Restart = 1 << 8,
+		NetFlag_PlayerScope = 1 << 9,
+
+		NetFlag_Count = 10
+	};
+
+	double QuantizeNetTime(double Time)
+	{
+		const double Resolution = GetDefault<UDynamicTimersSettings>()->GetNetTimeResolution();
+		return FMath::RoundToDouble(Time / Resolution) * Resolution;
+	}
+
+	// Ticks are signed, a start time rebased or restored to before the world began is negative.
+	// Zigzag encoding keeps small magnitudes of either sign short in the packed int.
+	template<typename TimeType>
+	void SerializeQuantizedTime(FArchive& Ar, TimeType& Value, double Resolution)
+	{
+		uint64 EncodedTicks = 0;
+		if (Ar.IsSaving())
+		{
+			const int64 Ticks = static_cast<int64>(FMath::RoundToDouble(Value / Resolution));
+			EncodedTicks = (static_cast<uint64>(Ticks) << 1) ^ static_cast<uint64>(Ticks >> 63);
+		}
+
+		Ar.SerializeIntPacked64(EncodedTicks);
+
+		if (Ar.IsLoading())
+		{
+			const int64 Ticks = static_cast<int64>(EncodedTicks >> 1) ^ -static_cast<int64>(EncodedTicks & 1);
+			Value = static_cast<TimeType>(Ticks * Resolution);
+		}
+	}
+
+	// Fast array delta serialization with the traffic counted; receiving also covers the item callbacks
+	template<typename ArrayType>
+	bool DeltaSerializeTimers(TArray<FTimeData>& Items, FNetDeltaSerializeInfo& DeltaParms, ArrayType& ArraySerializer)
+	{
+		if (FBitReader* Reader = DeltaParms.Reader)
+		{
+			TRACE_CPUPROFILER_EVENT_SCOPE(DynamicTimers::ReceiveTimers);
+			SCOPE_CYCLE_COUNTER(STAT_DynamicTimers_Receive);
+
+			const int64 StartBits = Reader->GetPosBits();
+			const bool bResult = FFastArraySerializer::FastArrayDeltaSerialize<FTimeData, ArrayType>(Items, DeltaParms, ArraySerializer);
+			const int64 NumBytes = (Reader->GetPosBits() - StartBits + 7) / 8;
+			INC_DWORD_STAT_BY(STAT_DynamicTimers_BytesReceived, NumBytes);
+#if !UE_BUILD_SHIPPING
+			GetNetTrafficCounters().BytesReceived += NumBytes;
+#endif
+			return bResult;
+		}
+
+		if (FBitWriter* Writer = DeltaParms.Writer)
+		{
+			const int64 StartBits = Writer->GetNumBits();
+			const bool bResult = FFastArraySerializer::FastArrayDeltaSerialize<FTimeData, ArrayType>(Items, DeltaParms, ArraySerializer);
+			const int64 NumBytes = (Writer->GetNumBits() - StartBits + 7) / 8;
+			INC_DWORD_STAT_BY(STAT_DynamicTimers_BytesSent, NumBytes);
+#if !UE_BUILD_SHIPPING
+			FNetTrafficCounters& Counters = GetNetTrafficCounters();
+			Counters.BytesSent += NumBytes;
+			if (!DeltaParms.OldState && !Items.IsEmpty())
+			{
+				Counters.InitialBytesSent += NumBytes;
+				++Counters.NumInitialSends;
+			}
+#endif
+			return bResult;
+		}
+
+		return FFastArraySerializer::FastArrayDeltaSerialize<FTimeData, ArrayType>(Items, DeltaParms, ArraySerializer);
+	}
+}
+
+bool FDTTimerArray::NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+{
+	return DynamicTimers::DeltaSerializeTimers(Items, DeltaParms, *this);
+}
+
+bool FDTRelevantTimerArray::NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+{
+	return DynamicTimers::DeltaSerializeTimers(Items, DeltaParms, *this);
+}
+
+bool FDTActorTimerArray::NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+{
+	return DynamicTimers::DeltaSerializeTimers(Items, DeltaParms, *this);
+}
+
+bool FTimeData::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	using namespace DynamicTimers;
+
+	// Every tag reports into its own flag, so a later tag cannot hide the failure of an earlier one
+	bool bTagsSerialized = true;
+	auto SerializeTag = [&Ar, Map, &bTagsSerialized](FGameplayTag& Tag)
+	{
+		bool bTagSerialized = true;
+		Tag.NetSerialize(Ar, Map, bTagSerialized);
+		bTagsSerialized &= bTagSerialized;
+	};
+
+	// Timers registered from the catalog send its index in place of their static data
+	const bool bHasDefinition = DefinitionIndex != INDEX_NONE;
+	uint16 Flags = (bIsStarted ? NetFlag_Started : 0) | (bIsPaused ? NetFlag_Paused : 0)
+		| (bHasDefinition ? NetFlag_Definition : 0) | (!bHasDefinition && bLooping ? NetFlag_Looping : 0)
+		| (!bHasDefinition && !Phases.IsEmpty() ? NetFlag_Phases : 0) | (!bHasDefinition && !Thresholds.IsEmpty() ? NetFlag_Thresholds : 0)
+		| (Rate != 1.0f ? NetFlag_Rate : 0) | (PredictionId != 0 ? NetFlag_Prediction : 0) | (RestartCount != 0 ? NetFlag_Restart : 0)
+		| (Scope == EDTTimerScope::Player ? NetFlag_PlayerScope : 0);
+	Ar.SerializeBits(&Flags, NetFlag_Count);
+	if (Ar.IsLoading())
+	{
+		bIsStarted = (Flags & NetFlag_Started) != 0;
+		bIsPaused = (Flags & NetFlag_Paused) != 0;
+
+		// Clients only need to know their own timers apart, the only ones they may predict
+		Scope = (Flags & NetFlag_PlayerScope) ? EDTTimerScope::Player : EDTTimerScope::Global;
+	}
+
+	const double Resolution = GetDefault<UDynamicTimersSettings>()->GetNetTimeResolution();
+	if (Flags & NetFlag_Definition)
+	{
+		uint32 Index = DefinitionIndex;
+		Ar.SerializeIntPacked(Index);
+		if (Ar.IsLoading())
+		{
+			const UDynamicTimerCatalog* Catalog = GetDefault<UDynamicTimersSettings>()->GetTimerCatalog();
+			const FTimeData* Prototype = Catalog ? Catalog->GetPrototype(static_cast<int32>(Index)) : nullptr;
+			if (!Prototype)
+			{
+				UE_LOG(LogDynamicTimers, Error, TEXT("Received timer definition %u, which the local timer catalog does not have"), Index);
+				Ar.SetError();
+				bOutSuccess = false;
+				return false;
+			}
+			CopyDefinitionFrom(*Prototype);
+		}
+	}
+	else
+	{
+		if (Ar.IsLoading())
+		{
+			DefinitionIndex = INDEX_NONE;
+			bLooping = (Flags & NetFlag_Looping) != 0;
+		}
+		SerializeTag(TimerTag);
+
+		if (Flags & NetFlag_Phases)
+		{
+			uint32 NumPhases = Phases.Num();
+			Ar.SerializeIntPacked(NumPhases);
+			if (Ar.IsLoading())
+			{
+				if (NumPhases > static_cast<uint32>(MaxTimerPhases))
+				{
+					Ar.SetError();
+					bOutSuccess = false;
+					return false;
+				}
+				Phases.SetNum(NumPhases);
+			}
+
+			// Summed from the quantized steps so phase boundaries and the end of the sequence agree on both sides
+			double TotalDuration = 0.0;
+			for (FDTTimerPhase& Phase : Phases)
+			{
+				SerializeTag(Phase.PhaseTag);
+				SerializeQuantizedTime(Ar, Phase.Duration, Resolution);
+				TotalDuration += Phase.Duration;
+			}
+
+			if (Ar.IsLoading())
+			{
+				Duration = static_cast<float>(TotalDuration);
+			}
+		}
+		else
+		{
+			if (Ar.IsLoading())
+			{
+				Phases.Reset();
+			}
+			SerializeQuantizedTime(Ar, Duration, Resolution);
+		}
+
+		if (Flags & NetFlag_Thresholds)
+		{
+			uint32 NumThresholds = Thresholds.Num();
+			Ar.SerializeIntPacked(NumThresholds);
+			if (Ar.IsLoading())
+			{
+				if (NumThresholds > static_cast<uint32>(MaxTimerThresholds))
+				{
+					Ar.SetError();
+					bOutSuccess = false;
+					return false;
+				}
+				Thresholds.SetNum(NumThresholds);
+			}
+
+			for (float& Threshold : Thresholds)
+			{
+				SerializeQuantizedTime(Ar, Threshold, Resolution);
+			}
+		}
+		else if (Ar.IsLoading())
+		{
+			Thresholds.Reset();
+		}
+	}
+
+	if (Flags & NetFlag_Rate)
+	{
+		Ar << Rate;
+		if (Ar.IsLoading() && !(Rate > 0.0f))
+		{
+			Ar.SetError();
+			bOutSuccess = false;
+			return false;
+		}
+	}
+	else if (Ar.IsLoading())
+	{
+		Rate = 1.0f;
+	}
+
+	if (Flags & NetFlag_Prediction)
+	{
+		Ar << PredictionId;
+	}
+	else if (Ar.IsLoading())
+	{
+		PredictionId = 0;
+	}
+
+	if (Flags & NetFlag_Restart)
+	{
+		Ar << RestartCount;
+	}
+	else if (Ar.IsLoading())
+	{
+		RestartCount = 0;
+	}
+
+	if (bIsStarted && !bIsPaused)
+	{
+		SerializeQuantizedTime(Ar, StartTime, Resolution);
+	}
+	else if (Ar.IsLoading())
+	{
+		StartTime = 0.0;
+	}
+
+	if (bIsPaused)
+	{
+		SerializeQuantizedTime(Ar, ElapsedTimeWhenPaused, Resolution);
+	}
+	else if (Ar.IsLoading())
+	{
+		ElapsedTimeWhenPaused = 0.0f;
+	}
+
+	bOutSuccess = bTagsSerialized && !Ar.IsError();
+	return true;
+}
+
+bool FTimeData::SetPhases(TConstArrayView<FDTTimerPhase> InPhases)
+{
+	if (InPhases.Num() > DynamicTimers::MaxTimerPhases)
+	{
+		UE_LOG(LogDynamicTimers, Warning, TEXT("%s: sequences are limited to %d phases"), *TimerTag.ToString(), DynamicTimers::MaxTimerPhases);
+		return false;
+	}
+
+	// Summed the way the receiver sums the replicated steps
+	double TotalDuration = 0.0;
+	for (const FDTTimerPhase& Phase : InPhases)
+	{
+		TotalDuration += DynamicTimers::QuantizeNetTime(FMath::Max(Phase.Duration, 0.0f));
+	}
+
+	if (TotalDuration <= 0.0)
+	{
+		UE_LOG(LogDynamicTimers, Warning, TEXT("%s: sequence has no duration"), *TimerTag.ToString());
+		return false;
+	}
+
+	Phases.Reset();
+	Phases.Append(InPhases.GetData(), InPhases.Num());
+	for (FDTTimerPhase& Phase : Phases)
+	{
+		Phase.Duration = DynamicTimers::QuantizeNetTime(FMath::Max(Phase.Duration, 0.0f));
+	}
+	Duration = static_cast<float>(TotalDuration);
+	return true;
+}
+
+void FTimeData::SetThresholds(TConstArrayView<float> InThresholds)
+{
+	Thresholds.Reset();
+	for (const float Threshold : InThresholds)
+	{
+		const float NetThreshold = DynamicTimers::QuantizeNetTime(Threshold);
+		if (NetThreshold > 0.0f && NetThreshold < Duration)
+		{
+			Thresholds.AddUnique(NetThreshold);
+		}
+	}
+	Thresholds.Sort(TGreater<float>());
+
+	if (Thresholds.Num() > DynamicTimers::MaxTimerThresholds)
+	{
+		UE_LOG(LogDynamicTimers, Warning, TEXT("%s: timers are limited to %d thresholds"), *TimerTag.ToString(), DynamicTimers::MaxTimerThresholds);
+		Thresholds.SetNum(DynamicTimers::MaxTimerThresholds);
+	}
+}
+
+void FTimeData::CopyDefinitionFrom(const FTimeData& Prototype)
+{
+	DefinitionIndex = Prototype.DefinitionIndex;
+	TimerTag = Prototype.TimerTag;
+	Duration = Prototype.Duration;
+	bLooping = Prototype.bLooping;
+	Phases = Prototype.Phases;
+	Thresholds = Prototype.Thresholds;
+}
+
+void FTimeData::PreReplicatedRemove(const FDTTimerArray& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->HandleTimerRemoved(*this);
+	}
+}
+
+void FTimeData::PostReplicatedAdd(const FDTTimerArray& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->HandleTimerAdded(*this);
+	}
+}
+
+void FTimeData::PostReplicatedChange(const FDTTimerArray& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->HandleTimerChanged(*this);
+	}
+}
+
+void FTimeData::PreReplicatedRemove(const FDTRelevantTimerArray& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->HandleRelevantTimerRemoved(*this);
+	}
+}
+
+void FTimeData::PostReplicatedAdd(const FDTRelevantTimerArray& InArraySerializer)
+{
+	// Everything on this stream that is not the player's own is a team timer
+	if (Scope != EDTTimerScope::Player)
+	{
+		Scope = EDTTimerScope::Team;
+	}
+
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->HandleRelevantTimerAdded(*this);
+	}
+}
+
+void FTimeData::PostReplicatedChange(const FDTRelevantTimerArray& InArraySerializer)
+{
+	if (Scope != EDTTimerScope::Player)
+	{
+		Scope = EDTTimerScope::Team;
+	}
+
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->HandleRelevantTimerChanged(*this);
+	}
+}
+
+void FTimeData::PreReplicatedRemove(const FDTActorTimerArray& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->HandleTimerRemoved(*this);
+	}
+}
+
+void FTimeData::PostReplicatedAdd(const FDTActorTimerArray& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->HandleTimerAdded(*this);
+	}
+}
+
+void FTimeData::PostReplicatedChange(const FDTActorTimerArray& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->HandleTimerChanged(*this);
+	}
+}
+
+double FTimeData::GetElapsedTime(double ServerTime) const
+{
+	if (!bIsStarted)
+	{
+		return 0.0;
+	}
+	return bIsPaused ? ElapsedTimeWhenPaused : FMath::Max(ServerTime - StartTime, 0.0) * Rate;
+}
+
+float FTimeData::GetRemainingTime(double ServerTime) const
+{
+	double ElapsedTime = GetElapsedTime(ServerTime);
+	if (bLooping && Duration > 0.0f)
+	{
+		ElapsedTime = FMath::Fmod(FMath::Max(ElapsedTime, 0.0), static_cast<double>(Duration));
+	}
+	return FMath::Max(0.0f, static_cast<float>(Duration - ElapsedTime));
+}
+
+FDTTimerPosition FTimeData::GetPosition(double ElapsedTime) const
+{
+	FDTTimerPosition Position;
+
+	ElapsedTime = FMath::Max(ElapsedTime, 0.0);
+	double CycleStart = 0.0;
+	if (bLooping && Duration > 0.0f)
+	{
+		Position.Loop = FMath::FloorToInt32(ElapsedTime / Duration);
+		CycleStart = static_cast<double>(Position.Loop) * Duration;
+	}
+	Position.BoundaryTime = CycleStart + Duration;
+
+	// Sequences are short, a walk over the steps is all it takes
+	const double CycleElapsed = ElapsedTime - CycleStart;
+	double PhaseEnd = 0.0;
+	for (int32 PhaseIndex = 0; PhaseIndex < Phases.Num(); ++PhaseIndex)
+	{
+		PhaseEnd += Phases[PhaseIndex].Duration;
+		if (CycleElapsed < PhaseEnd || PhaseIndex == Phases.Num() - 1)
+		{
+			Position.PhaseIndex = PhaseIndex;
+			Position.BoundaryTime = CycleStart + PhaseEnd;
+			break;
+		}
+	}
+
+	// Largest first, so they are reached in order as the remaining time comes down
+	const double CycleRemaining = Duration - CycleElapsed;
+	while (Position.NumThresholdsReached < Thresholds.Num() && CycleRemaining <= Thresholds[Position.NumThresholdsReached])
+	{
+		++Position.NumThresholdsReached;
+	}
+	if (Position.NumThresholdsReached < Thresholds.Num())
+	{
+		Position.BoundaryTime = FMath::Min(Position.BoundaryTime, CycleStart + Duration - Thresholds[Position.NumThresholdsReached]);
+	}
+
+	return Position;
+}
+
+void FTimeData::CopyStateFrom(const FTimeData& Other)
+{
+	const int32 KeepReplicationID = ReplicationID;
+	const int32 KeepReplicationKey = ReplicationKey;
+	const int32 KeepMostRecentArrayReplicationKey = MostRecentArrayReplicationKey;
+	const bool bKeepNotifiedStarted = bNotifiedStarted;
+	const bool bKeepNotifiedPaused = bNotifiedPaused;
+	const int32 KeepNotifiedPhaseIndex = NotifiedPhaseIndex;
+	const int32 KeepNotifiedLoop = NotifiedLoop;
+	const int32 KeepNotifiedThresholds = NotifiedThresholds;
+	const uint8 KeepNotifiedRestartCount = NotifiedRestartCount;
+
+	*this = Other;
+
+	ReplicationID = KeepReplicationID;
+	ReplicationKey = KeepReplicationKey;
+	MostRecentArrayReplicationKey = KeepMostRecentArrayReplicationKey;
+	bNotifiedStarted = bKeepNotifiedStarted;
+	bNotifiedPaused = bKeepNotifiedPaused;
+	NotifiedPhaseIndex = KeepNotifiedPhaseIndex;
+	NotifiedLoop = KeepNotifiedLoop;
+	NotifiedThresholds = KeepNotifiedThresholds;
+	NotifiedRestartCount = KeepNotifiedRestartCount;
+}
+
+void FDTTimerArray::PostReplicatedReceive(const FFastArraySerializer::FPostReplicatedReceiveParameters& Parameters)
+{
+	if (Owner)
+	{
+		Owner->HandleTimersReceived();
+	}
+}
+
+void FDTRelevantTimerArray::PostReplicatedReceive(const FFastArraySerializer::FPostReplicatedReceiveParameters& Parameters)
+{
+	if (Owner)
+	{
+		Owner->HandleRelevantTimersReceived();
+	}
+}
@@ -0,0 +1,68 @@
+#include "Types/DTTimeText.h"
+
+#include "Misc/StringBuilder.h"
+
+const FText& FDTTimeTextCache::Update(double TotalSeconds, EDTTimeFormat Format)
+{
+	const int64 NewDisplayedUnits = ToDisplayedUnits(TotalSeconds, Format);
+	if (NewDisplayedUnits != DisplayedUnits || Format != DisplayedFormat)
+	{
+		Text = BuildText(NewDisplayedUnits, Format);
+		DisplayedUnits = NewDisplayedUnits;
+		DisplayedFormat = Format;
+	}
+	return Text;
+}
+
+void FDTTimeTextCache::Reset()
+{
+	Text = FText::GetEmpty();
+	DisplayedUnits = INDEX_NONE;
+}
+
+FText FDTTimeTextCache::FormatTime(double TotalSeconds, EDTTimeFormat Format)
+{
+	return BuildText(ToDisplayedUnits(TotalSeconds, Format), Format);
+}
+
+int64 FDTTimeTextCache::ToDisplayedUnits(double TotalSeconds, EDTTimeFormat Format)
+{
+	double UnitsPerSecond = 1.0;
+	switch (Format)
+	{
+	case EDTTimeFormat::SecondsTenths:
+		UnitsPerSecond = 10.0;
+		break;
+	case EDTTimeFormat::MinutesSecondsMillis:
+		UnitsPerSecond = 1000.0;
+		break;
+	default:
+		break;
+	}
+
+	return FMath::FloorToInt64(FMath::Max(0.0, TotalSeconds) * UnitsPerSecond);
+}
+
+FText FDTTimeTextCache::BuildText(int64 DisplayedUnits, EDTTimeFormat Format)
+{
+	// Digits are written into a stack buffer from fixed patterns; the only allocation is the resulting text
+	TStringBuilder<32> Builder;
+
+	switch (Format)
+	{
+	case EDTTimeFormat::HoursMinutesSeconds:
+		Builder.Appendf(TEXT("%02lld:%02lld:%02lld"), DisplayedUnits / 3600, DisplayedUnits / 60 % 60, DisplayedUnits % 60);
+		break;
+	case EDTTimeFormat::SecondsTenths:
+		Builder.Appendf(TEXT("%lld.%lld"), DisplayedUnits / 10, DisplayedUnits % 10);
+		break;
+	case EDTTimeFormat::MinutesSecondsMillis:
+		Builder.Appendf(TEXT("%02lld:%02lld.%03lld"), DisplayedUnits / 60000, DisplayedUnits / 1000 % 60, DisplayedUnits % 1000);
+		break;
+	default:
+		Builder.Appendf(TEXT("%02lld:%02lld"), DisplayedUnits / 60, DisplayedUnits % 60);
+		break;
+	}
+
+	return FText::AsCultureInvariant(FString(Builder.ToView()));
+}
@@ -0,0 +1,126 @@
+#include "Types/DTTimerReadSnapshot.h"
+
+#include "Types/DTStructTypes.h"
+
+template<typename ReaderType>
+auto FDTTimerReadSnapshot::Read(ReaderType&& Reader) const
+{
+	for (;;)
+	{
+		const int32 Index = PublishedIndex.load();
+		FBuffer& Buffer = Buffers[Index];
+		Buffer.NumReaders.fetch_add(1);
+
+		// If a publish swapped the buffers before the registration landed, the game thread may be refilling this one
+		if (PublishedIndex.load() == Index)
+		{
+			auto Result = Reader(Buffer.Entries);
+			Buffer.NumReaders.fetch_sub(1);
+			return Result;
+		}
+		Buffer.NumReaders.fetch_sub(1);
+	}
+}
+
+bool FDTTimerReadSnapshot::Publish(TConstArrayView<FTimeData> Timers, TConstArrayView<FTimeData> LocalTimers)
+{
+	check(IsInGameThread());
+
+	const int32 SpareIndex = 1 - PublishedIndex.load();
+	FBuffer& Buffer = Buffers[SpareIndex];
+	if (Buffer.NumReaders.load() != 0)
+	{
+		return false;
+	}
+
+	Buffer.Entries.Reset();
+	for (const TConstArrayView<FTimeData>& TimerSet : { Timers, LocalTimers })
+	{
+		for (const FTimeData& TimerData : TimerSet)
+		{
+			FEntry& Entry = Buffer.Entries.Add(TimerData.TimerTag);
+			Entry.StartTime = TimerData.StartTime;
+			Entry.Duration = TimerData.Duration;
+			Entry.ElapsedTimeWhenPaused = TimerData.ElapsedTimeWhenPaused;
+			Entry.Rate = TimerData.Rate;
+			Entry.bIsStarted = TimerData.bIsStarted;
+			Entry.bIsPaused = TimerData.bIsPaused;
+			Entry.bLooping = TimerData.bLooping;
+		}
+	}
+
+	PublishedIndex.store(SpareIndex);
+	return true;
+}
+
+void FDTTimerReadSnapshot::UpdateClock(double ServerTime, double ClockRate)
+{
+	check(IsInGameThread());
+
+	ClockSequence.fetch_add(1);
+	AnchorServerTime.store(ServerTime);
+	AnchorPlatformTime.store(FPlatformTime::Seconds());
+	AnchorClockRate.store(ClockRate);
+	ClockSequence.fetch_add(1);
+}
+
+double FDTTimerReadSnapshot::GetServerTime() const
+{
+	double ServerTime;
+	double PlatformTime;
+	double ClockRate;
+	uint32 Sequence;
+	do
+	{
+		Sequence = ClockSequence.load();
+		ServerTime = AnchorServerTime.load();
+		PlatformTime = AnchorPlatformTime.load();
+		ClockRate = AnchorClockRate.load();
+	}
+	while ((Sequence & 1) != 0 || ClockSequence.load() != Sequence);
+
+	return ServerTime + (FPlatformTime::Seconds() - PlatformTime) * ClockRate;
+}
+
+bool FDTTimerReadSnapshot::GetRemainingTime(const FGameplayTag& TimerTag, float& OutRemainingTime) const
+{
+	const double ServerTime = GetServerTime();
+	return Read([&TimerTag, &OutRemainingTime, ServerTime](const TMap<FGameplayTag, FEntry>& Entries)
+	{
+		const FEntry* Entry = Entries.Find(TimerTag);
+		OutRemainingTime = Entry ? Entry->GetRemainingTime(ServerTime) : 0.0f;
+		return Entry != nullptr;
+	});
+}
+
+bool FDTTimerReadSnapshot::IsTimerRunning(const FGameplayTag& TimerTag) const
+{
+	return Read([&TimerTag](const TMap<FGameplayTag, FEntry>& Entries)
+	{
+		const FEntry* Entry = Entries.Find(TimerTag);
+		return Entry && Entry->bIsStarted && !Entry->bIsPaused;
+	});
+}
+
+int32 FDTTimerReadSnapshot::GetNumTimers() const
+{
+	return Read([](const TMap<FGameplayTag, FEntry>& Entries)
+	{
+		return Entries.Num();
+	});
+}
+
+float FDTTimerReadSnapshot::FEntry::GetRemainingTime(double ServerTime) const
+{
+	// Same evaluation as FTimeData::GetRemainingTime
+	double ElapsedTime = 0.0;
+	if (bIsStarted)
+	{
+		ElapsedTime = bIsPaused ? ElapsedTimeWhenPaused : FMath::Max(ServerTime - StartTime, 0.0) * Rate;
+	}
+	if (bLooping && Duration > 0.0f)
+	{
+		ElapsedTime = FMath::Fmod(FMath::Max(ElapsedTime, 0.0), static_cast<double>(Duration));
+	}
+	return FMath::Max(0.0f, static_cast<float>(Duration - ElapsedTime));
+}
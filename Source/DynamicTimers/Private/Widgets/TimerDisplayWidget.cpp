@@ -3,7 +3,77 @@
 
 #include "Widgets/TimerDisplayWidget.h"
 
+#include "Components/DynamicTimersComponent.h"
+#include "GameFramework/GameStateBase.h"
+#include "Widgets/TimerListItemData.h"
+
+void UTimerDisplayWidget::NativeConstruct()
+{
+	Super::NativeConstruct();
+
+	if (!bReceiveRemainingTimeUpdates) return;
+
+	const UWorld* World = GetWorld();
+	const AGameStateBase* GameState = World ? World->GetGameState() : nullptr;
+	TimersComponent = GameState ? GameState->FindComponentByClass<UDynamicTimersComponent>() : nullptr;
+
+	if (UDynamicTimersComponent* Component = TimersComponent.Get())
+	{
+		Component->RegisterTimerDisplay(this);
+	}
+}
+
+void UTimerDisplayWidget::NativeDestruct()
+{
+	if (UDynamicTimersComponent* Component = TimersComponent.Get())
+	{
+		Component->UnregisterTimerDisplay(this);
+	}
+	TimersComponent.Reset();
+
+	Super::NativeDestruct();
+}
+
 void UTimerDisplayWidget::SetTimerTag(FGameplayTag InTag)
 {
 	TimerTag = InTag;
+
+	if (UDynamicTimersComponent* Component = TimersComponent.Get())
+	{
+		Component->RequestTimerDisplayUpdate();
+	}
+}
+
+void UTimerDisplayWidget::NativeOnRemainingTimeUpdated(float RemainingTime)
+{
+	OnRemainingTimeUpdated(RemainingTime);
+}
+
+FText UTimerDisplayWidget::FormatRemainingTime(float RemainingTime)
+{
+	return RemainingTimeText.Update(RemainingTime, TimeFormat);
+}
+
+void UTimerDisplayWidget::SetTimerActive(bool bIsActive)
+{
+	if (bIsActive)
+	{
+		OnTimerActivated();
+	}
+	else
+	{
+		OnTimerDeactivated();
+	}
+}
+
+void UTimerDisplayWidget::NativeOnListItemObjectSet(UObject* ListItemObject)
+{
+	IUserObjectListEntry::NativeOnListItemObjectSet(ListItemObject);
+
+	// Entries are recycled as rows scroll, so the whole state comes from the item every time
+	if (const UTimerListItemData* ItemData = Cast<UTimerListItemData>(ListItemObject))
+	{
+		SetTimerTag(ItemData->TimerTag);
+		SetTimerActive(ItemData->bIsActive);
+	}
 }
@@ -4,51 +4,96 @@
 #include "Widgets/TimerManagerWidget.h"
 
 #include "Components/DynamicTimersComponent.h"
+#include "Components/ListView.h"
 #include "Components/PanelWidget.h"
+#include "GameFramework/GameStateBase.h"
+#include "Widgets/TimerListItemData.h"
+
+UTimerManagerWidget::UTimerManagerWidget(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+	, TimerWidgetPool(*this)
+{
+}
+
+void UTimerManagerWidget::ReleaseSlateResources(bool bReleaseChildren)
+{
+	Super::ReleaseSlateResources(bReleaseChildren);
+
+	TimerWidgetPool.ReleaseAllSlateResources();
+}
 
 void UTimerManagerWidget::NativeConstruct()
 {
 	Super::NativeConstruct();
 
-	if (UWorld* World = GetWorld())
+	const UWorld* World = GetWorld();
+	const AGameStateBase* GameState = World ? World->GetGameState() : nullptr;
+	TimersComponent = GameState ? GameState->FindComponentByClass<UDynamicTimersComponent>() : nullptr;
+
+	if (UDynamicTimersComponent* Component = TimersComponent.Get())
 	{
-		CachedGameState = World->GetGameState<AGameStateBase>();
-		if (CachedGameState)
-		{
-			CachedGameState->FindComponentByClass<UDynamicTimersComponent>()->OnTimerRegistered.AddDynamic(this, &UTimerManagerWidget::HandleTimerRegistered);
-			CachedGameState->FindComponentByClass<UDynamicTimersComponent>()->OnTimerStarted.AddDynamic(this, &UTimerManagerWidget::HandleTimerStarted);
-			CachedGameState->FindComponentByClass<UDynamicTimersComponent>()->OnTimerFinished.AddDynamic(this, &UTimerManagerWidget::HandleTimerFinished);
-			CachedGameState->FindComponentByClass<UDynamicTimersComponent>()->OnTimerPaused.AddDynamic(this, &UTimerManagerWidget::HandleTimerPaused);
-			CachedGameState->FindComponentByClass<UDynamicTimersComponent>()->OnTimerResumed.AddDynamic(this, &UTimerManagerWidget::HandleTimerResumed);
-		}
+		// Without a filter, the empty tag with its children stands for every timer
+		TimerEventsHandle = Component->SubscribeToTimer(FilterTimerTag, !FilterTimerTag.IsValid(),
+			FDTTimerEventDelegate::CreateUObject(this, &UTimerManagerWidget::HandleTimerEvent));
 	}
 }
 
 void UTimerManagerWidget::NativeDestruct()
 {
-	if (CachedGameState)
+	if (UDynamicTimersComponent* Component = TimersComponent.Get())
 	{
-		if (UDynamicTimersComponent* TimersComponent = CachedGameState->FindComponentByClass<UDynamicTimersComponent>())
-		{
-			TimersComponent->OnTimerRegistered.RemoveDynamic(this, &UTimerManagerWidget::HandleTimerRegistered);
-			TimersComponent->OnTimerStarted.RemoveDynamic(this, &UTimerManagerWidget::HandleTimerStarted);
-			TimersComponent->OnTimerFinished.RemoveDynamic(this, &UTimerManagerWidget::HandleTimerFinished);
-			TimersComponent->OnTimerPaused.RemoveDynamic(this, &UTimerManagerWidget::HandleTimerPaused);
-			TimersComponent->OnTimerResumed.RemoveDynamic(this, &UTimerManagerWidget::HandleTimerResumed);
-		}
+		Component->UnsubscribeFromTimer(TimerEventsHandle);
 	}
+	TimerEventsHandle.Reset();
+	TimersComponent.Reset();
 	
 	Super::NativeDestruct();
 }
 
-void UTimerManagerWidget::HandleTimerRegistered(FGameplayTag TimerTag, float Duration)
+void UTimerManagerWidget::HandleTimerEvent(const FDTTimerEventData& EventData)
+{
+	switch (EventData.Event)
+	{
+	case EDTTimerEvent::Registered:
+		HandleTimerRegistered(EventData.TimerTag);
+		break;
+	case EDTTimerEvent::Started:
+	case EDTTimerEvent::Resumed:
+		SetTimerActive(EventData.TimerTag, true);
+		break;
+	case EDTTimerEvent::Paused:
+		SetTimerActive(EventData.TimerTag, false);
+		break;
+	case EDTTimerEvent::Finished:
+		HandleTimerFinished(EventData.TimerTag);
+		break;
+	default:
+		break;
+	}
+}
+
+void UTimerManagerWidget::HandleTimerRegistered(const FGameplayTag& TimerTag)
 {
-	const bool bPassesFilter = !FilterTimerTag.IsValid() || TimerTag.MatchesTagExact(FilterTimerTag);
-	if (!bPassesFilter) return;
+	if (TimersListView)
+	{
+		if (ActiveTimerItems.Contains(TimerTag)) return;
+
+		UTimerListItemData* Item = PooledTimerItems.IsEmpty() ? nullptr : PooledTimerItems.Pop(EAllowShrinking::No).Get();
+		if (!Item)
+		{
+			Item = NewObject<UTimerListItemData>(this);
+		}
+		Item->TimerTag = TimerTag;
+		Item->bIsActive = false;
+
+		ActiveTimerItems.Add(TimerTag, Item);
+		TimersListView->AddItem(Item);
+		return;
+	}
 	
-	if (!TimersContainer || !TimerDisplayWidgetClass) return;
+	if (!TimersContainer || !TimerDisplayWidgetClass || ActiveTimerWidgets.Contains(TimerTag)) return;
 
-	if (UTimerDisplayWidget* NewWidget = CreateWidget<UTimerDisplayWidget>(this, TimerDisplayWidgetClass))
+	if (UTimerDisplayWidget* NewWidget = TimerWidgetPool.GetOrCreateInstance<UTimerDisplayWidget>(TimerDisplayWidgetClass))
 	{
 		NewWidget->SetTimerTag(TimerTag);
 		TimersContainer->AddChild(NewWidget);
@@ -58,38 +103,50 @@ void UTimerManagerWidget::HandleTimerRegistered(FGameplayTag TimerTag, float Dur
 	}
 }
 
-void UTimerManagerWidget::HandleTimerStarted(FGameplayTag TimerTag, float Duration)
+void UTimerManagerWidget::HandleTimerFinished(const FGameplayTag& TimerTag)
 {
-	if (UTimerDisplayWidget** FoundWidget = ActiveTimerWidgets.Find(TimerTag))
+	TObjectPtr<UTimerListItemData> FoundItem;
+	if (ActiveTimerItems.RemoveAndCopyValue(TimerTag, FoundItem))
 	{
-		(*FoundWidget)->OnTimerActivated();
+		if (TimersListView)
+		{
+			TimersListView->RemoveItem(FoundItem);
+		}
+		PooledTimerItems.Add(FoundItem);
+		return;
 	}
-}
 
-void UTimerManagerWidget::HandleTimerFinished(FGameplayTag TimerTag)
-{
 	UTimerDisplayWidget* FoundWidget = nullptr;
 	if (ActiveTimerWidgets.RemoveAndCopyValue(TimerTag, FoundWidget))
 	{
 		if (FoundWidget)
 		{
+			// Back to the pool rather than to the garbage collector
 			FoundWidget->RemoveFromParent();
+			TimerWidgetPool.Release(FoundWidget);
 		}
 	}
 }
 
-void UTimerManagerWidget::HandleTimerPaused(FGameplayTag TimerTag)
+void UTimerManagerWidget::SetTimerActive(const FGameplayTag& TimerTag, bool bIsActive)
 {
-	if (UTimerDisplayWidget** FoundWidget = ActiveTimerWidgets.Find(TimerTag))
+	if (TObjectPtr<UTimerListItemData>* FoundItem = ActiveTimerItems.Find(TimerTag))
 	{
-		(*FoundWidget)->OnTimerDeactivated();
+		(*FoundItem)->bIsActive = bIsActive;
+
+		// Rows that are not on screen pick the state up from the item when they are generated
+		if (TimersListView)
+		{
+			if (UTimerDisplayWidget* EntryWidget = TimersListView->GetEntryWidgetFromItem<UTimerDisplayWidget>(FoundItem->Get()))
+			{
+				EntryWidget->SetTimerActive(bIsActive);
+			}
+		}
+		return;
 	}
-}
 
-void UTimerManagerWidget::HandleTimerResumed(FGameplayTag TimerTag)
-{
 	if (UTimerDisplayWidget** FoundWidget = ActiveTimerWidgets.Find(TimerTag))
 	{
-		(*FoundWidget)->OnTimerActivated();
+		(*FoundWidget)->SetTimerActive(bIsActive);
 	}
 }
@@ -0,0 +1,58 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+#include "Components/ActorComponent.h"
+#include "Types/DTStructTypes.h"
+#include "DynamicActorTimersComponent.generated.h"
+
+class UDynamicTimersSubsystem;
+
+/**
+ * Replication bridge for the per-actor timers of UDynamicTimersSubsystem. Only actors that carry this
+ * component have their timers replicated, and only to the connections the actor is relevant to.
+ * The timers travel as FTimeData, so clients evaluate them against the synced server clock like any other.
+ */
+UCLASS(ClassGroup=(Custom), meta=(BlueprintSpawnableComponent))
+class DYNAMICTIMERS_API UDynamicActorTimersComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UDynamicActorTimersComponent();
+
+	virtual void PostInitProperties() override;
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	UFUNCTION(BlueprintPure, Category="Dynamic Timers|Actor Timers")
+	bool GetTimerRemainingTime(FGameplayTag TimerTag, float& RemainingTime) const;
+
+	// State changes of this actor's timers, on the server as they are made and on clients as they arrive
+	FDTTimerEventMulticastDelegate OnTimerEvent;
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	friend struct FTimeData;
+	friend class UDynamicTimersSubsystem;
+
+	UPROPERTY(Replicated)
+	FDTActorTimerArray ReplicatedTimers;
+
+	// Server side, called by the subsystem
+	void UpsertTimer(const FTimeData& TimerData, bool bRestarted = false);
+	void RemoveTimer(const FGameplayTag& TimerTag);
+
+	// Replicated item callbacks on clients, shared with the server side updates
+	void HandleTimerAdded(FTimeData& TimerData);
+	void HandleTimerChanged(FTimeData& TimerData);
+	void HandleTimerRemoved(const FTimeData& TimerData);
+
+	void BroadcastTimerEvent(EDTTimerEvent Event, const FTimeData& TimerData) const;
+
+	double GetServerTime() const;
+};
@@ -5,16 +5,26 @@
 #include "CoreMinimal.h"
 #include "GameplayTagContainer.h"
 #include "Components/ActorComponent.h"
+#include "Types/DTDeadlineQueue.h"
+#include "Types/DTStructTypes.h"
+#include "Types/DTTimerReadSnapshot.h"
 #include "DynamicTimersComponent.generated.h"
 
 struct FBulkTimerRegistrationData;
-struct FTimeData;
+class AGameModeBase;
+class UDynamicTimerCatalog;
+class UDynamicTimersPlayerComponent;
+class UTimerDisplayWidget;
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOntimerRegistered, FGameplayTag, TimerTag, float, Duration);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOntimerStarted, FGameplayTag, TimerTag, float, Duration);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOntimerFinished, FGameplayTag, TimerTag);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOntimerPaused, FGameplayTag, TimerTag);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOntimerResumed, FGameplayTag, TimerTag);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOntimerPhaseChanged, FGameplayTag, TimerTag, FGameplayTag, PhaseTag, int32, PhaseIndex);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOntimerLooped, FGameplayTag, TimerTag);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOntimerThresholdReached, FGameplayTag, TimerTag, float, Threshold);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOntimerPredictionRejected, FGameplayTag, TimerTag);
 
 UCLASS(ClassGroup=(Custom), meta=(BlueprintSpawnableComponent))
 class DYNAMICTIMERS_API UDynamicTimersComponent : public UActorComponent
@@ -28,9 +38,56 @@ public:
 	UFUNCTION(BlueprintCallable, Category="Dynamic Timers|Time Formatting")
 	void RegisterTimer(FGameplayTag TimerTag, float Duration);
 
+	// Registers a timer that restarts every Duration seconds until it is removed
+	UFUNCTION(BlueprintCallable, Category= "Dynamic Timers", meta=(BlueprintAuthorityOnly))
+	void RegisterLoopingTimer(FGameplayTag TimerTag, float Duration);
+
+	// Registers one timer that runs the phases back to back (e.g. warmup, round, overtime), optionally looping.
+	// Phase changes are worked out on each machine from the start time, nothing is replicated per phase.
+	UFUNCTION(BlueprintCallable, Category= "Dynamic Timers", meta=(BlueprintAuthorityOnly))
+	void RegisterTimerSequence(FGameplayTag TimerTag, const TArray<FDTTimerPhase>& Phases, bool bLoop);
+
+	// Registers a timer that only replicates to the connections it is relevant to: a team, or a single player
+	UFUNCTION(BlueprintCallable, Category= "Dynamic Timers", meta=(BlueprintAuthorityOnly))
+	void RegisterScopedTimer(FGameplayTag TimerTag, float Duration, EDTTimerScope Scope, uint8 TeamId, APlayerController* OwningPlayer);
+
+	// Registers a timer from the catalog set in the project settings. Only the definition's index replicates, the tag,
+	// duration, phases and thresholds come from each machine's copy of the catalog. OwningPlayer is for player scoped definitions.
+	UFUNCTION(BlueprintCallable, Category="Dynamic Timers|Definitions", meta=(BlueprintAuthorityOnly))
+	bool RegisterTimerFromDefinition(FGameplayTag TimerTag, APlayerController* OwningPlayer = nullptr);
+
+	// RegisterTimerFromDefinition for several timers in one commit; returns how many were registered.
+	// OwningPlayer is used for every player scoped definition among them, which are skipped without one.
+	UFUNCTION(BlueprintCallable, Category="Dynamic Timers|Definitions", meta=(BlueprintAuthorityOnly))
+	int32 RegisterTimersFromDefinitions(const FGameplayTagContainer& TimerTags, APlayerController* OwningPlayer = nullptr);
+
+	// Speeds a timer up or slows it down from now on (e.g. 2 for a contested capture point). Costs one small update.
+	UFUNCTION(BlueprintCallable, Category= "Dynamic Timers", meta=(BlueprintAuthorityOnly))
+	void SetTimerTimeScale(FGameplayTag TimerTag, float TimeScale);
+
+	// Remaining times at which OnTimerThresholdReached fires, e.g. 60, 10 and 5 for countdown warnings. Every
+	// machine fires them from its own clock, so they cost nothing once the timer has replicated. Set them
+	// before the timer starts; thresholds outside the timer's duration are dropped.
+	UFUNCTION(BlueprintCallable, Category= "Dynamic Timers", meta=(BlueprintAuthorityOnly))
+	void SetTimerThresholds(FGameplayTag TimerTag, const TArray<float>& Thresholds);
+
+	// Lets a timer run in real time while the world is slowed down or sped up
+	UFUNCTION(BlueprintCallable, Category= "Dynamic Timers", meta=(BlueprintAuthorityOnly))
+	void SetTimerIgnoresTimeDilation(FGameplayTag TimerTag, bool bIgnoreTimeDilation);
+
+	// Team used to decide which team scoped timers replicate to this player
+	UFUNCTION(BlueprintCallable, Category= "Dynamic Timers", meta=(BlueprintAuthorityOnly))
+	void SetPlayerTimerTeam(APlayerController* PlayerController, uint8 TeamId);
+
 	UFUNCTION(BlueprintCallable, Category= "Dynamic Timers", meta=(BlueprintAuthorityOnly))
 	void StartGlobalTimer(FGameplayTag TimerTag);
 	
+	// Starts a timer at a later server time, e.g. GetServerTime() + 3 for a round that begins in three seconds.
+	// The start time replicates ahead, and every machine fires OnTimerStarted from its own synced clock when it
+	// comes, so clients begin together and nothing is sent at that moment. Times in the past start it now.
+	UFUNCTION(BlueprintCallable, Category= "Dynamic Timers", meta=(BlueprintAuthorityOnly))
+	void StartGlobalTimerAt(FGameplayTag TimerTag, double StartServerTime);
+
 	UFUNCTION(BlueprintCallable, Category= "Dynamic Timers", meta=(BlueprintAuthorityOnly))
 	void RemoveGlobalTimer(FGameplayTag TimerTag);
 	
@@ -40,6 +97,12 @@ public:
 	UFUNCTION(BlueprintCallable, Category= "Dynamic Timers", meta=(BlueprintAuthorityOnly))
 	void ResumeGlobalTimer(FGameplayTag TimerTag);
 
+	// Starts, pauses or resumes one of the local player's own timers right away and asks the server to do
+	// the same. Clients only predict player scoped timers owned by this player, anything else returns false;
+	// if the server refuses, the timer rolls back and OnTimerPredictionRejected fires. Applies directly on the server.
+	UFUNCTION(BlueprintCallable, Category="Dynamic Timers|Prediction")
+	bool PredictTimerOperation(FGameplayTag TimerTag, EDTTimerOperation Operation);
+
 	// Bulk Timer Functions
 	UFUNCTION(BlueprintCallable, Category= "Dynamic Timers", meta=(BlueprintAuthorityOnly))
 	void RegisterGlobalTimers(const TArray<FBulkTimerRegistrationData>& TimersToRegister);
@@ -47,16 +110,89 @@ public:
 	UFUNCTION(BlueprintCallable, Category="Dynamic Timers", meta=(BlueprintAuthorityOnly))
 	void StartGlobalTimers(const FGameplayTagContainer TimerTagsToStart);
 
+	// StartGlobalTimerAt for several timers, which then share the start time exactly
+	UFUNCTION(BlueprintCallable, Category="Dynamic Timers", meta=(BlueprintAuthorityOnly))
+	void StartGlobalTimersAt(const FGameplayTagContainer& TimerTags, double StartServerTime);
+
 	UFUNCTION(BlueprintCallable, Category="Dynamic Timers", meta=(BlueprintAuthorityOnly))
 	void PauseGlobalTimers(const FGameplayTagContainer TimerTags);
 
 	UFUNCTION(BlueprintCallable, Category="Dynamic Timers", meta=(BlueprintAuthorityOnly))
 	void ResumeGlobalTimers(const FGameplayTagContainer& TimerTags);
+
+	// Applies an operation to ParentTag and every timer below it (e.g. Round for Round.Warmup and Round.Overtime)
+	// as a single batch. Returns the number of timers that changed.
+	UFUNCTION(BlueprintCallable, Category="Dynamic Timers", meta=(BlueprintAuthorityOnly))
+	int32 ApplyToTimersUnder(FGameplayTag ParentTag, EDTTimerOperation Operation);
+
+	// Same as ApplyToTimersUnder for every timer whose tag matches Query
+	UFUNCTION(BlueprintCallable, Category="Dynamic Timers", meta=(BlueprintAuthorityOnly))
+	int32 ApplyToTimersMatchingQuery(const FGameplayTagQuery& Query, EDTTimerOperation Operation);
+
+	// Tags of the active timers at or below ParentTag
+	UFUNCTION(BlueprintCallable, Category="Dynamic Timers")
+	void GetTimersUnder(FGameplayTag ParentTag, TArray<FGameplayTag>& OutTimerTags) const;
 	
+	// Mutations between Begin and End are committed together: one expiry re-arm, one replication update and
+	// one round of event broadcasts. Outside an explicit batch, changes are coalesced at the end of the frame.
+	UFUNCTION(BlueprintCallable, Category="Dynamic Timers", meta=(BlueprintAuthorityOnly))
+	void BeginTimerBatch();
+
+	UFUNCTION(BlueprintCallable, Category="Dynamic Timers", meta=(BlueprintAuthorityOnly))
+	void EndTimerBatch();
+
+	// Writes every timer to a versioned binary blob keyed by tag name, e.g. to carry the timers over
+	// seamless travel or to recover them after a server restart. Player scoped timers are left out,
+	// their controllers do not survive either.
+	UFUNCTION(BlueprintCallable, Category="Dynamic Timers|Snapshot", meta=(BlueprintAuthorityOnly))
+	void ExportTimerSnapshot(TArray<uint8>& OutSnapshot) const;
+
+	// Replaces the current timers with the ones in a snapshot, each carrying on from the elapsed time it was
+	// exported with; starts scheduled ahead keep their remaining delay. Timers the snapshot also holds are updated
+	// in place without finishing; the ones it lacks are removed and finish. Everything is restored in one commit. Returns false if the snapshot could not be read,
+	// in which case the current timers are left alone.
+	UFUNCTION(BlueprintCallable, Category="Dynamic Timers|Snapshot", meta=(BlueprintAuthorityOnly))
+	bool RestoreTimerSnapshot(const TArray<uint8>& Snapshot);
+
+	// Server world time in seconds. Clients use the estimate kept by their UDynamicTimersPlayerComponent,
+	// so replicated start times can be compared against it directly.
+	UFUNCTION(BlueprintPure, Category="Dynamic Timers")
+	double GetServerTime() const;
+
 	// Get the remaining time for a specific timer
 	UFUNCTION(BlueprintPure, Category="Dynamic Timers")
 	bool GetTimerRemainingTime(FGameplayTag TimerTag, float& RemainingTime) const;
 
+	// Current phase of a sequence and the time left in it
+	UFUNCTION(BlueprintPure, Category="Dynamic Timers")
+	bool GetTimerPhase(FGameplayTag TimerTag, FGameplayTag& PhaseTag, int32& PhaseIndex, float& PhaseRemainingTime) const;
+
+	// Remaining time of every timer in one pass. OutRemainingTimes is reset, keeping its allocation.
+	UFUNCTION(BlueprintCallable, Category="Dynamic Timers")
+	void GetAllRemainingTimes(TArray<FDTRemainingTime>& OutRemainingTimes) const;
+
+	// Remaining times for worker threads, published after every commit that changes a timer. Only kept up to
+	// date when bPublishReadSnapshots is set in the project settings; readers must not outlive the component.
+	const FDTTimerReadSnapshot& GetReadSnapshot() const { return ReadSnapshot; }
+
+	// Registered displays get their timer's remaining time pushed from a single update pass,
+	// at the rate configured in the project settings
+	UFUNCTION(BlueprintCallable, Category="Dynamic Timers|Display")
+	void RegisterTimerDisplay(UTimerDisplayWidget* Display);
+
+	UFUNCTION(BlueprintCallable, Category="Dynamic Timers|Display")
+	void UnregisterTimerDisplay(UTimerDisplayWidget* Display);
+
+	// Runs the display pass on the next tick, e.g. after a display switched to another timer
+	void RequestTimerDisplayUpdate();
+
+	// Native alternative to the Blueprint events for one timer, or with bIncludeChildren for every timer
+	// under TimerTag; an empty tag with children covers all timers. Only the subscribers matching an event
+	// are called, without going through reflection. Subscribing from inside a callback is allowed.
+	FDelegateHandle SubscribeToTimer(FGameplayTag TimerTag, bool bIncludeChildren, FDTTimerEventDelegate Delegate);
+
+	void UnsubscribeFromTimer(FDelegateHandle Handle);
+
 
 	// Dynamic Delegates
 	// These are used to notify when a timer is registered, started, finished, paused, resumed
@@ -75,22 +211,263 @@ public:
 	UPROPERTY(BlueprintAssignable, Category="Dynamic Timers")
 	FOntimerResumed OnTimerResumed;
 
+	// A sequence entered a phase, including the first one when it starts
+	UPROPERTY(BlueprintAssignable, Category="Dynamic Timers")
+	FOntimerPhaseChanged OnTimerPhaseChanged;
+
+	UPROPERTY(BlueprintAssignable, Category="Dynamic Timers")
+	FOntimerLooped OnTimerLooped;
+
+	// The remaining time of a timer came down to one of its thresholds, in every loop of a looping timer
+	UPROPERTY(BlueprintAssignable, Category="Dynamic Timers")
+	FOntimerThresholdReached OnTimerThresholdReached;
+
+	// The server refused a PredictTimerOperation call and the timer went back to its replicated state
+	UPROPERTY(BlueprintAssignable, Category="Dynamic Timers|Prediction")
+	FOntimerPredictionRejected OnTimerPredictionRejected;
+
+	virtual void PostInitProperties() override;
+
 protected:
 	// Called when the game starts
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 public:
-	UPROPERTY(ReplicatedUsing= OnRep_ActiveTimers)
-	TArray<FTimeData> ActiveTimers;
-
-	UFUNCTION()
-	void OnRep_ActiveTimers();
+	UPROPERTY(Replicated)
+	FDTTimerArray ActiveTimers;
 
 	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 
 private:
+	friend struct FTimeData;
+	friend struct FDTTimerArray;
+	friend class UDynamicTimersPlayerComponent;
+	friend struct FDynamicTimersBenchmark;
+	friend struct FDynamicTimersDump;
+	friend struct FDynamicTimersNetHarness;
+
+	// Server-side expiry: a single engine timer armed for the earliest deadline in ExpiryQueue
+	void OnExpiryTimerFired();
+
+	// Loop and phase boundaries of running timers, on every machine. Events only, nothing is replicated.
+	void OnBoundaryTimerFired();
+	void UpdateTimerPosition(FTimeData& TimerData, double ServerTime);
+
+	// Queues OnTimerStarted once a timer has actually begun, which for a scheduled start is when ServerTime reaches it
+	void UpdateNotifiedStart(FTimeData& TimerData, double ServerTime);
+
+	void ScheduleExpiry(const FTimeData& TimerData);
+
+	// Rate of a timer given its time scale and the current world time dilation
+	float GetTimerRate(const FTimeData& TimerData) const;
+	// False if the rate was already current and nothing changed
+	bool RebaseTimerRate(FTimeData& TimerData, double CurrentTime);
 
-	void OnServerTimerFinished(FGameplayTag TimerTag);
+	// Server only, while timers that ignore time dilation exist
+	void UpdateTimeDilation();
 
-	TArray<FTimeData> Old_ActiveTimers;
+	float AppliedTimeDilation = 1.0f;
+
+	struct FArmedDeadlineTimer
+	{
+		FTimerHandle Handle;
+		double ArmedDeadline = -1.0;
+	};
+
+	// Points an engine timer at the earliest deadline of a queue, leaving it alone if that has not changed
+	void RearmDeadlineTimer(const FDTDeadlineQueue& Queue, FArmedDeadlineTimer& ArmedTimer, void (UDynamicTimersComponent::*Callback)());
+	void RearmTimerSchedules();
+
+	FDTDeadlineQueue ExpiryQueue;
+
+	FDTDeadlineQueue BoundaryQueue;
+
+	FArmedDeadlineTimer ExpiryTimer;
+	FArmedDeadlineTimer BoundaryTimer;
+
+	TArray<FGameplayTag> ExpiredTimerTags;
+
+	// Absorbs the float drift between the timer manager and world time when collecting due timers
+	static constexpr double ExpiryTolerance = 0.001;
+
+	// Tag lookup into ActiveTimers, kept in sync on add/remove and rebuilt on clients after replication.
+	// On clients it falls back to the mirrored scoped timers.
+	FTimeData* FindTimer(const FGameplayTag& TimerTag);
+	const FTimeData* FindTimer(const FGameplayTag& TimerTag) const;
+	FTimeData* FindMirroredTimer(const FGameplayTag& TimerTag);
+
+	int32 GetNumTimers() const { return ActiveTimers.Items.Num() + MirroredTimers.Num(); }
+
+	FTimeData& AddTimer(const FTimeData& NewTimerData);
+	bool RemoveTimer(const FGameplayTag& TimerTag);
+
+	void RebuildTimerIndex();
+
+	void AddToTimerHierarchy(const FGameplayTag& TimerTag);
+	void RemoveFromTimerHierarchy(const FGameplayTag& TimerTag);
+
+	// Server-side add and remove, including replication and events
+	void RegisterTimerData(const FTimeData& NewTimerData);
+	bool RegisterDefinedTimer(const UDynamicTimerCatalog& Catalog, const FGameplayTag& TimerTag, APlayerController* OwningPlayer);
+	bool DestroyTimer(const FGameplayTag& TimerTag);
+
+	// Server-side state change of a single timer; returns false if the timer is missing or already in that state
+	bool ApplyTimerOperation(const FGameplayTag& TimerTag, EDTTimerOperation Operation, double CurrentTime);
+	int32 ApplyTimerOperation(TConstArrayView<FGameplayTag> TimerTags, EDTTimerOperation Operation);
+	int32 ApplyTimerOperation(TConstArrayView<FGameplayTag> TimerTags, EDTTimerOperation Operation, double CurrentTime);
+
+	// Marks a mutated timer for replication and queues the events for its new state
+	void MarkTimerDirty(FTimeData& TimerData);
+
+	// Global timers replicate through ActiveTimers, scoped ones through the relevant player components
+	void ReplicateTimer(FTimeData& TimerData);
+	void ReplicateTimerRemoval(const FTimeData& TimerData);
+	void ForEachRelevantPlayerComponent(const FTimeData& TimerData, TFunctionRef<void(UDynamicTimersPlayerComponent&)> Callback);
+
+	// Client-side local copies of the scoped timers received by the local player component
+	void AddMirroredTimer(const FTimeData& TimerData);
+	void UpdateMirroredTimer(const FTimeData& TimerData);
+	void RemoveMirroredTimer(const FGameplayTag& TimerTag);
+
+	// Client only. Kept apart from ActiveTimers, whose items must all be known to the fast array:
+	// local edits there would leave its replication map pointing at the wrong slots.
+	TArray<FTimeData> MirroredTimers;
+	TMap<FGameplayTag, int32> MirroredTimerIndexByTag;
+
+	// Server side of PredictTimerOperation, called through the player component's RPC
+	bool ApplyPredictedTimerOperation(const APlayerController* PlayerController, uint16 PredictionId, const FGameplayTag& TimerTag, EDTTimerOperation Operation, double PredictedTime);
+
+	// Client side, restores the replicated state the prediction was made on top of
+	void HandleTimerPredictionRejected(uint16 PredictionId, const FGameplayTag& TimerTag);
+
+	struct FTimerPrediction
+	{
+		uint16 PredictionId;
+
+		// Latest state replicated for the timer, kept up to date until the server confirms the prediction
+		FTimeData AuthoritativeState;
+	};
+
+	// Client only
+	TMap<FGameplayTag, FTimerPrediction> PendingPredictions;
+	uint16 NextPredictionId = 0;
+
+	// Called after every mutation. The commit runs when the outermost batch ends, or at the end of the frame.
+	void CommitTimerChanges();
+	void FlushTimerChanges();
+	void HandleWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+	// Shared by server mutations and the replicated item callbacks on clients
+	void HandleTimerAdded(FTimeData& TimerData);
+	void HandleTimerChanged(FTimeData& TimerData);
+	void HandleTimerRemoved(const FTimeData& TimerData);
+	void HandleTimersReceived();
+
+	void QueueTimerEvent(EDTTimerEvent Event, const FTimeData& TimerData, int32 PhaseIndex = INDEX_NONE, float Threshold = 0.0f);
+	void FlushTimerEvents();
+
+	// Moves the process wide timer stats by this component's change since its last report
+	void ReportTimerStats(int32 NumActive, int32 NumPaused, int32 NumPending);
+
+	// Kept in step with the notified state, so they are right on clients too
+	int32 NumStartedTimers = 0;
+	int32 NumPausedTimers = 0;
+
+	struct FReportedTimerStats
+	{
+		int32 NumActive = 0;
+		int32 NumPaused = 0;
+		int32 NumPending = 0;
+	};
+
+	FReportedTimerStats ReportedTimerStats;
+
+	// Publishes ReadSnapshot, or leaves it dirty for the end of frame handler if a reader holds the spare buffer
+	void PublishReadSnapshot();
+
+	FDTTimerReadSnapshot ReadSnapshot;
+
+	// Only armed while a registered display shows a running timer
+	void UpdateTimerDisplays();
+
+	TArray<TWeakObjectPtr<UTimerDisplayWidget>> TimerDisplays;
+
+	FTimerHandle DisplayUpdateTimerHandle;
+
+	TArray<FDTTimerEventData> PendingTimerEvents;
+
+	// Calls the native subscribers of the event's tag and of each of its parents
+	void NotifyTimerSubscribers(const FDTTimerEventData& EventData) const;
+
+	struct FTimerSubscribers
+	{
+		FDTTimerEventMulticastDelegate Exact;
+		FDTTimerEventMulticastDelegate WithChildren;
+	};
+
+	// Boxed so a subscription made during a broadcast cannot move the delegate being broadcast.
+	// Emptied entries are kept, listeners tend to come back for the same tags.
+	TMap<FGameplayTag, TUniquePtr<FTimerSubscribers>> TimerSubscribers;
+
+	TMap<FDelegateHandle, FGameplayTag> SubscribedTagByHandle;
+
+	TMap<FGameplayTag, int32> TimerIndexByTag;
+
+	// Every tag in the hierarchy of an active timer, mapped to the timers at or below it
+	TMap<FGameplayTag, TSet<FGameplayTag>> TimerTagsByAncestor;
+
+	FDelegateHandle PostActorTickHandle;
+	FDelegateHandle PostLoginHandle;
+
+	void HandleGameModePostLogin(AGameModeBase* GameMode, APlayerController* NewPlayer);
+
+	// Finds or creates the player's component; a component seen for the first time gets the scoped timers relevant to it
+	UDynamicTimersPlayerComponent* AddPlayerComponent(APlayerController* PlayerController);
+
+	// Sends a connection the scoped timers relevant to its player and team, and takes back the others
+	void SyncRelevantTimers(UDynamicTimersPlayerComponent& PlayerComponent);
+
+	mutable TWeakObjectPtr<const UDynamicTimersPlayerComponent> CachedPlayerComponent;
+
+	// Server only
+	TArray<TWeakObjectPtr<UDynamicTimersPlayerComponent>> PlayerComponents;
+
+	int32 TimerBatchDepth = 0;
+
+	bool bTimerIndexDirty = false;
+	bool bTimerArrayDirty = false;
+	bool bTimerPropertyDirty = false;
+	bool bUseNetDormancy = false;
+	bool bHasPendingTimerChanges = false;
+	bool bIsFlushingTimerEvents = false;
+	bool bTrackTimeDilation = false;
+	bool bPublishReadSnapshot = false;
+	bool bReadSnapshotDirty = false;
+};
+
+/** Groups every timer mutation made during its lifetime into a single commit */
+struct FDynamicTimersBatchScope
+{
+	explicit FDynamicTimersBatchScope(UDynamicTimersComponent* InComponent)
+		: Component(InComponent)
+	{
+		if (Component)
+		{
+			Component->BeginTimerBatch();
+		}
+	}
+
+	~FDynamicTimersBatchScope()
+	{
+		if (Component)
+		{
+			Component->EndTimerBatch();
+		}
+	}
+
+	UE_NONCOPYABLE(FDynamicTimersBatchScope);
+
+private:
+	UDynamicTimersComponent* Component;
 };
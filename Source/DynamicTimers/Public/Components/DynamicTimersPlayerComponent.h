@@ -0,0 +1,119 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "Types/DTStructTypes.h"
+#include "DynamicTimersPlayerComponent.generated.h"
+
+class UDynamicTimersComponent;
+
+/**
+ * Per-connection companion of UDynamicTimersComponent, added to every PlayerController by the server.
+ * Estimates the offset between the owning client's clock (real time, run at the replicated time dilation and
+ * stopped while paused) and the server's world clock so replicated timestamps can be evaluated locally without
+ * further replication, and carries the team and player scoped timers relevant to this connection.
+ */
+UCLASS(ClassGroup=(Custom), Within=PlayerController)
+class DYNAMICTIMERS_API UDynamicTimersPlayerComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UDynamicTimersPlayerComponent();
+
+	virtual void PostInitProperties() override;
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	// Best estimate of the server's world time, in seconds
+	UFUNCTION(BlueprintPure, Category="Dynamic Timers|Clock")
+	double GetServerTime() const;
+
+	UFUNCTION(BlueprintPure, Category="Dynamic Timers|Clock")
+	bool HasClockSync() const { return bHasClockSync; }
+
+	// Round trip time of the sample the current estimate is based on
+	UFUNCTION(BlueprintPure, Category="Dynamic Timers|Clock")
+	float GetClockSyncRoundTripTime() const { return static_cast<float>(BestRoundTripTime); }
+
+	uint8 GetTimerTeamId() const { return TimerTeamId; }
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	friend struct FTimeData;
+	friend struct FDTRelevantTimerArray;
+	friend class UDynamicTimersComponent;
+	friend class FDynamicTimersPredictionTest;
+
+	UPROPERTY(Replicated)
+	FDTRelevantTimerArray RelevantTimers;
+
+	// Server only, see UDynamicTimersComponent::SetPlayerTimerTeam
+	uint8 TimerTeamId = DynamicTimers::NoTeam;
+
+	void SetTimerTeamId(uint8 InTeamId) { TimerTeamId = InTeamId; }
+
+	// Server-side mirror maintenance
+	void UpsertRelevantTimer(const FTimeData& TimerData);
+	void RemoveRelevantTimer(const FGameplayTag& TimerTag);
+
+	// Client-side forwarding into the game state's timers component
+	void HandleRelevantTimerAdded(const FTimeData& TimerData);
+	void HandleRelevantTimerChanged(const FTimeData& TimerData);
+	void HandleRelevantTimerRemoved(const FTimeData& TimerData);
+	void HandleRelevantTimersReceived();
+	void ForwardRelevantTimers(UDynamicTimersComponent& TimersComponent) const;
+	UDynamicTimersComponent* FindTimersComponent() const;
+
+	UFUNCTION(Server, Reliable)
+	void ServerPredictTimerOperation(uint16 PredictionId, FGameplayTag TimerTag, EDTTimerOperation Operation, double PredictedTime);
+
+	// Only refusals are sent back; accepted predictions are confirmed by the replicated timer
+	UFUNCTION(Client, Reliable)
+	void ClientRejectTimerPrediction(uint16 PredictionId, FGameplayTag TimerTag);
+
+	UFUNCTION(Server, Unreliable)
+	void ServerRequestServerTime(double ClientSendTime);
+
+	UFUNCTION(Client, Unreliable)
+	void ClientReceiveServerTime(double ClientSendTime, double ServerTime);
+
+	void SendClockSyncRequest();
+	void ScheduleNextClockSync();
+	void ApplyClockSample(double LocalTime, double RoundTripTime, double SampleOffset);
+
+	double GetLocalTime() const;
+
+	// Local clock = LocalClockTime + (real time - LocalClockRealTime) * LocalClockRate, rebased whenever the rate changes
+	mutable double LocalClockTime = 0.0;
+	mutable double LocalClockRealTime = 0.0;
+	mutable double LocalClockRate = 1.0;
+
+	struct FClockSample
+	{
+		double RoundTripTime;
+		double Offset;
+	};
+
+	// Recent samples; the lowest round trip is the one least skewed by queuing delay
+	static constexpr int32 MaxClockSamples = 8;
+	TArray<FClockSample, TInlineAllocator<MaxClockSamples>> ClockSamples;
+	int32 NextSampleSlot = 0;
+
+	FTimerHandle ClockSyncTimerHandle;
+
+	// Server time = local time + ClockOffset + ClockDrift * (local time - OffsetLocalTime)
+	double ClockOffset = 0.0;
+	double ClockDrift = 0.0;
+	double OffsetLocalTime = 0.0;
+
+	double BestRoundTripTime = 0.0;
+
+	int32 BurstRequestsRemaining = 0;
+
+	bool bHasClockSync = false;
+};
@@ -0,0 +1,91 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+#include "Engine/DataAsset.h"
+#include "Types/DTStructTypes.h"
+#include "DynamicTimerCatalog.generated.h"
+
+class UWorld;
+
+// Static data of one timer, authored once instead of at every registration
+USTRUCT(BlueprintType)
+struct FDTTimerDefinition
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Dynamic Timers")
+	FGameplayTag TimerTag;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Dynamic Timers", meta = (ClampMin = "0.0", Units = "s"))
+	float Duration = 0.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Dynamic Timers")
+	bool bLooping = false;
+
+	// When set, Duration is ignored and the timer runs these steps in order
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Dynamic Timers")
+	TArray<FDTTimerPhase> Phases;
+
+	// Remaining times that fire OnTimerThresholdReached
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Dynamic Timers")
+	TArray<float> Thresholds;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Dynamic Timers", meta = (ClampMin = "0.001"))
+	float TimeScale = 1.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Dynamic Timers")
+	bool bIgnoreTimeDilation = false;
+
+	// Player scoped definitions are registered with the player they belong to
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Relevancy")
+	EDTTimerScope Scope = EDTTimerScope::Global;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Relevancy", meta = (EditCondition = "Scope == EDTTimerScope::Team"))
+	uint8 TeamId = DynamicTimers::NoTeam;
+};
+
+/**
+ * Timer definitions for UDynamicTimersComponent::RegisterTimerFromDefinition. They are ordered by tag name when
+ * loaded, and a timer registered from one replicates its position in that order instead of its static data.
+ * Server and clients must therefore run the same catalog, set in the project settings.
+ */
+UCLASS(BlueprintType)
+class DYNAMICTIMERS_API UDynamicTimerCatalog : public UPrimaryDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	virtual void PostLoad() override;
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+	// INDEX_NONE if the tag has no usable definition
+	int32 FindDefinitionIndex(const FGameplayTag& TimerTag) const;
+
+	// A registered, not yet started timer for the definition, or null for an index out of range
+	const FTimeData* GetPrototype(int32 DefinitionIndex) const;
+
+	int32 GetNumDefinitions() const { return Prototypes.Num(); }
+
+	UPROPERTY(EditDefaultsOnly, Category = "Dynamic Timers", meta = (TitleProperty = "TimerTag"))
+	TArray<FDTTimerDefinition> Definitions;
+
+private:
+	// Validates the definitions and sorts them by tag name, which does not depend on the order tags were loaded in
+	void BuildPrototypes();
+
+#if WITH_EDITOR
+	// Runs a rebuild held back by an edit made during Play In Editor once the last session's world goes away
+	void HandleWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources);
+
+	FDelegateHandle DeferredRebuildHandle;
+#endif
+
+	TArray<FTimeData> Prototypes;
+
+	TMap<FGameplayTag, int32> IndexByTag;
+};
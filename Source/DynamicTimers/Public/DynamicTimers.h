@@ -4,6 +4,38 @@
 
 #include "Modules/ModuleManager.h"
 
+DYNAMICTIMERS_API DECLARE_LOG_CATEGORY_EXTERN(LogDynamicTimers, Log, All);
+
+DECLARE_STATS_GROUP(TEXT("Dynamic Timers"), STATGROUP_DynamicTimers, STATCAT_Advanced);
+
+// Summed over every timers component in the process
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Active Timers"), STAT_DynamicTimers_ActiveTimers, STATGROUP_DynamicTimers, DYNAMICTIMERS_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Paused Timers"), STAT_DynamicTimers_PausedTimers, STATGROUP_DynamicTimers, DYNAMICTIMERS_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Pending Timers"), STAT_DynamicTimers_PendingTimers, STATGROUP_DynamicTimers, DYNAMICTIMERS_API);
+
+// Per frame
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Event Broadcasts"), STAT_DynamicTimers_Broadcasts, STATGROUP_DynamicTimers, DYNAMICTIMERS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Replicated Bytes Sent"), STAT_DynamicTimers_BytesSent, STATGROUP_DynamicTimers, DYNAMICTIMERS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Replicated Bytes Received"), STAT_DynamicTimers_BytesReceived, STATGROUP_DynamicTimers, DYNAMICTIMERS_API);
+
+#if !UE_BUILD_SHIPPING
+namespace DynamicTimers
+{
+	// Running totals of the timer arrays' replication in this process, kept without stats for the net harness
+	struct FNetTrafficCounters
+	{
+		uint64 BytesSent = 0;
+		uint64 BytesReceived = 0;
+
+		// Full states sent to a connection that had none of a non-empty array, i.e. what a late joiner gets
+		uint64 InitialBytesSent = 0;
+		uint32 NumInitialSends = 0;
+	};
+
+	DYNAMICTIMERS_API FNetTrafficCounters& GetNetTrafficCounters();
+}
+#endif
+
 class FDynamicTimersModule : public IModuleInterface
 {
 public:
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "Components/DynamicTimersComponent.h"
+#include "Types/DTTimeText.h"
 #include "Kismet/BlueprintFunctionLibrary.h"
 #include "DynamicTimersFunctionLibrary.generated.h"
 
@@ -18,6 +19,13 @@ class DYNAMICTIMERS_API UDynamicTimersFunctionLibrary : public UBlueprintFunctio
 	UFUNCTION(BlueprintPure, Category= "Dynamic Timers|Time Formatting", meta=(DisplayName= "Format Time to MM:SS"))
 	static FText FormatTimeToString(float TotalSeconds);
 
+	UFUNCTION(BlueprintPure, Category= "Dynamic Timers|Time Formatting", meta=(DisplayName= "Format Time"))
+	static FText FormatTime(float TotalSeconds, EDTTimeFormat Format);
+
+	// For bindings that run every frame: returns the cached text until the displayed value changes
+	UFUNCTION(BlueprintCallable, Category= "Dynamic Timers|Time Formatting", meta=(DisplayName= "Format Time (Cached)"))
+	static FText FormatTimeCached(UPARAM(ref) FDTTimeTextCache& Cache, float TotalSeconds, EDTTimeFormat Format);
+
 	UFUNCTION(BlueprintPure, Category= "Dynamic Timers|Components", meta=(DisplayName= "Get Dynamic Timers Component"))
 	static UDynamicTimersComponent* GetDynamicTimersComponent(const AGameStateBase* GameState);
 };
@@ -0,0 +1,80 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DeveloperSettings.h"
+#include "DynamicTimersSettings.generated.h"
+
+class UDynamicTimerCatalog;
+
+/**
+ * Project-wide settings for the Dynamic Timers plugin (Project Settings > Plugins > Dynamic Timers).
+ * Values that affect the wire format must match between server and clients, so they are read from config only.
+ */
+UCLASS(Config=Game, DefaultConfig, meta=(DisplayName="Dynamic Timers"))
+class DYNAMICTIMERS_API UDynamicTimersSettings : public UDeveloperSettings
+{
+	GENERATED_BODY()
+
+public:
+	UDynamicTimersSettings();
+
+	virtual FName GetCategoryName() const override;
+
+	double GetNetTimeResolution() const { return FMath::Max<double>(NetTimeResolution, UE_KINDA_SMALL_NUMBER); }
+
+	float GetDisplayUpdateInterval() const { return 1.0f / FMath::Max(DisplayUpdateRate, 1.0f); }
+
+	// Loaded on first use and kept for the rest of the process; null when no catalog is set
+	const UDynamicTimerCatalog* GetTimerCatalog() const;
+
+	// Step, in seconds, that replicated durations and timestamps are quantized to
+	UPROPERTY(Config, EditAnywhere, Category="Replication", meta=(ClampMin="0.001", UIMin="0.001", Units="s"))
+	float NetTimeResolution = 0.01f;
+
+	// Keep the actor owning the timers component dormant and only wake it for commits that change timers.
+	// Every other replicated property of that actor stops updating too, so only enable this when the
+	// component lives on an actor that replicates nothing else frequently.
+	UPROPERTY(Config, EditAnywhere, Category="Replication")
+	bool bUseNetDormancy = false;
+
+	// Definitions for RegisterTimerFromDefinition. Their timers replicate a definition index instead of their
+	// static data, so the server and its clients must run the same catalog.
+	UPROPERTY(Config, EditAnywhere, Category="Replication")
+	TSoftObjectPtr<UDynamicTimerCatalog> TimerCatalog;
+
+	// Seconds between clock sync round trips once the client has an estimate
+	UPROPERTY(Config, EditAnywhere, Category="Clock", meta=(ClampMin="0.5", Units="s"))
+	float ClockSyncInterval = 10.0f;
+
+	// Round trips sent back to back when a client first connects, to converge quickly
+	UPROPERTY(Config, EditAnywhere, Category="Clock", meta=(ClampMin="1", ClampMax="32"))
+	int32 ClockSyncBurstCount = 5;
+
+	// Offset error above which the client clock jumps instead of slewing towards the new estimate
+	UPROPERTY(Config, EditAnywhere, Category="Clock", meta=(ClampMin="0.0", Units="s"))
+	float ClockSnapThreshold = 0.25f;
+
+	// How far back the server accepts the time a client predicted an operation at. The rest of the
+	// client's latency is absorbed by a small correction when the authoritative state arrives.
+	UPROPERTY(Config, EditAnywhere, Category="Prediction", meta=(ClampMin="0.0", ClampMax="1.0", Units="s"))
+	float MaxPredictionRewind = 0.25f;
+
+	// Keep a copy of the timers that worker threads can query, see UDynamicTimersComponent::GetReadSnapshot.
+	// Each commit that changes a timer copies all of them, so leave this off unless something reads it.
+	UPROPERTY(Config, EditAnywhere, Category="Threading")
+	bool bPublishReadSnapshots = false;
+
+	// Updates per second pushed to registered timer displays while one of their timers is running
+	UPROPERTY(Config, EditAnywhere, Category="Display", meta=(ClampMin="1.0", ClampMax="120.0", EditCondition="!bUpdateDisplaysOnWholeSeconds"))
+	float DisplayUpdateRate = 10.0f;
+
+	// Instead of a fixed rate, update displays only when a running timer crosses a whole second
+	UPROPERTY(Config, EditAnywhere, Category="Display")
+	bool bUpdateDisplaysOnWholeSeconds = false;
+
+private:
+	UPROPERTY(Transient)
+	mutable TObjectPtr<const UDynamicTimerCatalog> LoadedTimerCatalog;
+};
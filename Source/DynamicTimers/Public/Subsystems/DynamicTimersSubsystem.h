@@ -0,0 +1,145 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Types/DTStructTypes.h"
+#include "UObject/ObjectKey.h"
+#include "DynamicTimersSubsystem.generated.h"
+
+class UDynamicActorTimersComponent;
+
+DECLARE_MULTICAST_DELEGATE_TwoParams(FDTActorTimerEventDelegate, AActor*, const FDTTimerEventData&);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnActorTimerFinished, AActor*, Actor, FGameplayTag, TimerTag);
+
+/**
+ * Store for large numbers of small per-actor timers, such as cooldowns and buff durations, keyed by
+ * (actor, tag). Unlike UDynamicTimersComponent it does not replicate by itself: timers of actors that
+ * carry a UDynamicActorTimersComponent are mirrored into it, the rest stay local to this machine.
+ * Timers follow the FTimeData model: registered, started, paused and resumed, with a fixed duration.
+ */
+UCLASS()
+class DYNAMICTIMERS_API UDynamicTimersSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// Adds a timer to the actor, or resets the existing one to the new duration. With bStart the
+	// countdown begins right away, which makes this the one call needed to (re)trigger a cooldown.
+	UFUNCTION(BlueprintCallable, Category="Dynamic Timers|Actor Timers")
+	void RegisterActorTimer(AActor* Actor, FGameplayTag TimerTag, float Duration, bool bStart = true);
+
+	UFUNCTION(BlueprintCallable, Category="Dynamic Timers|Actor Timers")
+	bool StartActorTimer(AActor* Actor, FGameplayTag TimerTag);
+
+	UFUNCTION(BlueprintCallable, Category="Dynamic Timers|Actor Timers")
+	bool PauseActorTimer(AActor* Actor, FGameplayTag TimerTag);
+
+	UFUNCTION(BlueprintCallable, Category="Dynamic Timers|Actor Timers")
+	bool ResumeActorTimer(AActor* Actor, FGameplayTag TimerTag);
+
+	UFUNCTION(BlueprintCallable, Category="Dynamic Timers|Actor Timers")
+	bool RemoveActorTimer(AActor* Actor, FGameplayTag TimerTag);
+
+	// Removes every timer of the actor; destroyed actors are cleaned up automatically
+	UFUNCTION(BlueprintCallable, Category="Dynamic Timers|Actor Timers")
+	int32 RemoveActorTimers(AActor* Actor);
+
+	UFUNCTION(BlueprintPure, Category="Dynamic Timers|Actor Timers")
+	bool GetActorTimerRemainingTime(AActor* Actor, FGameplayTag TimerTag, float& RemainingTime) const;
+
+	UFUNCTION(BlueprintPure, Category="Dynamic Timers|Actor Timers")
+	bool IsActorTimerRunning(AActor* Actor, FGameplayTag TimerTag) const;
+
+	UFUNCTION(BlueprintPure, Category="Dynamic Timers|Actor Timers")
+	int32 GetNumActorTimers() const { return Keys.Num(); }
+
+	// Every state change, including expiry, for native listeners
+	FDTActorTimerEventDelegate OnActorTimerEvent;
+
+	UPROPERTY(BlueprintAssignable, Category="Dynamic Timers|Actor Timers")
+	FOnActorTimerFinished OnActorTimerFinished;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	friend class UDynamicActorTimersComponent;
+
+	struct FActorTimerKey
+	{
+		TObjectKey<AActor> Actor;
+		FGameplayTag TimerTag;
+
+		bool operator==(const FActorTimerKey& Other) const { return Actor == Other.Actor && TimerTag == Other.TimerTag; }
+
+		friend uint32 GetTypeHash(const FActorTimerKey& Key)
+		{
+			return HashCombineFast(GetTypeHash(Key.Actor), GetTypeHash(Key.TimerTag));
+		}
+	};
+
+	struct FDeadlineEntry
+	{
+		double Deadline;
+		FActorTimerKey Key;
+
+		bool operator<(const FDeadlineEntry& Other) const { return Deadline < Other.Deadline; }
+	};
+
+	enum ETimerFlags : uint8
+	{
+		Flag_Started = 1 << 0,
+		Flag_Paused = 1 << 1
+	};
+
+	int32 FindTimerIndex(AActor* Actor, const FGameplayTag& TimerTag) const;
+	void RemoveTimerAt(int32 Index);
+	bool IsRunning(int32 Index) const { return (Flags[Index] & (Flag_Started | Flag_Paused)) == Flag_Started; }
+	float GetRemainingTime(int32 Index, double CurrentTime) const;
+	void SetDeadline(int32 Index, double Deadline);
+	void RebuildDeadlineHeap();
+	double GetCurrentTime() const;
+
+	void HandleActorDestroyed(AActor* Actor);
+
+	void NotifyTimerChanged(int32 Index, EDTTimerEvent Event);
+	void NotifyTimerRemoved(const FActorTimerKey& Key, float Duration);
+
+	// Mirrors a timer into its actor's UDynamicActorTimersComponent, if the actor has one
+	void UpdateBridge(int32 Index, bool bRestarted = false);
+	FTimeData MakeTimerData(int32 Index) const;
+
+	void AddBridge(UDynamicActorTimersComponent& Bridge);
+	void RemoveBridge(UDynamicActorTimersComponent& Bridge);
+
+	// Structure of arrays, one slot per timer. Deadlines holds the expiry time of running timers and
+	// the largest double for the rest.
+	TArray<FActorTimerKey> Keys;
+	TArray<double> Deadlines;
+	TArray<float> Durations;
+	TArray<float> RemainingTimes;
+	TArray<uint8> Flags;
+
+	TMap<FActorTimerKey, int32> IndexByKey;
+
+	// Timers per actor, so destroyed actors without any are skipped cheaply
+	TMap<TObjectKey<AActor>, int32> NumTimersByActor;
+
+	TMap<TObjectKey<AActor>, TWeakObjectPtr<UDynamicActorTimersComponent>> BridgesByActor;
+
+	// Min-heap of deadlines, so a tick only touches the timers that are due. Rescheduling pushes a new entry
+	// rather than moving the old one; entries that no longer match their timer's deadline are dropped when popped.
+	TArray<FDeadlineEntry> DeadlineHeap;
+
+	TArray<TPair<FActorTimerKey, float>> ExpiredTimers;
+
+	FDelegateHandle ActorDestroyedHandle;
+};
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+
+/**
+ * Indexed binary min-heap of timer deadlines keyed by tag.
+ * Scheduling, rescheduling and cancelling an entry are all O(log n).
+ */
+struct DYNAMICTIMERS_API FDTDeadlineQueue
+{
+	// Inserts the tag or moves its existing entry to the new deadline
+	void Schedule(const FGameplayTag& TimerTag, double Deadline);
+
+	bool Cancel(const FGameplayTag& TimerTag);
+
+	bool IsScheduled(const FGameplayTag& TimerTag) const { return PositionByTag.Contains(TimerTag); }
+
+	bool IsEmpty() const { return Heap.IsEmpty(); }
+
+	int32 Num() const { return Heap.Num(); }
+
+	// Earliest deadline, only valid when the queue is not empty
+	double PeekDeadline() const { return Heap[0].Deadline; }
+
+	// Pops every entry due at or before Now, earliest first
+	void PopExpired(double Now, TArray<FGameplayTag>& OutExpired);
+
+	void Reset();
+
+	// Bulk loading: entries are appended as they come and put in heap order by one O(n) Heapify,
+	// which must run before the queue is used again. The tag must not be scheduled already.
+	void AddUnordered(const FGameplayTag& TimerTag, double Deadline);
+	void Heapify();
+
+private:
+	struct FEntry
+	{
+		double Deadline;
+		FGameplayTag TimerTag;
+	};
+
+	void SiftUp(int32 Index);
+	void SiftDown(int32 Index);
+	void SwapEntries(int32 A, int32 B);
+	void RemoveAt(int32 Index);
+
+	TArray<FEntry> Heap;
+	TMap<FGameplayTag, int32> PositionByTag;
+};
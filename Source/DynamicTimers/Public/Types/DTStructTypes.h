@@ -2,18 +2,139 @@
 
 #include "CoreMinimal.h"
 #include "GameplayTagContainer.h"
+#include "Net/Serialization/FastArraySerializer.h"
 #include "DTStructTypes.generated.h"
 
+class APlayerController;
+class UDynamicTimersComponent;
+class UDynamicTimersPlayerComponent;
+class UDynamicActorTimersComponent;
+struct FDTTimerArray;
+struct FDTRelevantTimerArray;
+struct FDTActorTimerArray;
+
+namespace DynamicTimers
+{
+	// Team id of players that have not been assigned one; team scoped timers never match it
+	constexpr uint8 NoTeam = 255;
+
+	// Upper bound on the steps of a timer sequence, also enforced when receiving one
+	constexpr int32 MaxTimerPhases = 64;
+
+	// Upper bound on the warning thresholds of a timer, also enforced when receiving them
+	constexpr int32 MaxTimerThresholds = 16;
+
+	// Slowest a timer can run; use pause to stop one
+	constexpr float MinTimeScale = 0.001f;
+
+	// Rounds a time to the configured net resolution. The server stores its durations and timestamps
+	// this way, so it evaluates timers from exactly the values its clients receive.
+	DYNAMICTIMERS_API double QuantizeNetTime(double Time);
+
+	inline float QuantizeNetTime(float Time)
+	{
+		return static_cast<float>(QuantizeNetTime(static_cast<double>(Time)));
+	}
+
+	// Prediction ids wrap around, so ordering is decided on the difference
+	inline bool IsPredictionAtOrAfter(uint16 PredictionId, uint16 OtherPredictionId)
+	{
+		return static_cast<int16>(PredictionId - OtherPredictionId) >= 0;
+	}
+}
+
+// State change applied by the tag based bulk operations
+UENUM(BlueprintType)
+enum class EDTTimerOperation : uint8
+{
+	Start,
+	Pause,
+	Resume,
+	Remove
+};
+
+// Which connections a timer replicates to
+UENUM(BlueprintType)
+enum class EDTTimerScope : uint8
+{
+	Global,
+	Team,
+	Player
+};
+
+UENUM()
+enum class EDTTimerEvent : uint8
+{
+	Registered,
+	Started,
+	Paused,
+	Resumed,
+	Finished,
+	PhaseChanged,
+	Looped,
+	ThresholdReached
+};
+
+// What native subscribers receive for each timer event
+struct FDTTimerEventData
+{
+	EDTTimerEvent Event;
+	FGameplayTag TimerTag;
+	float Duration;
+
+	// Only set for PhaseChanged
+	FGameplayTag PhaseTag;
+	int32 PhaseIndex;
+
+	// Only set for ThresholdReached
+	float Threshold = 0.0f;
+};
+
+DECLARE_DELEGATE_OneParam(FDTTimerEventDelegate, const FDTTimerEventData&);
+DECLARE_MULTICAST_DELEGATE_OneParam(FDTTimerEventMulticastDelegate, const FDTTimerEventData&);
+
+// One step of a timer sequence
+USTRUCT(BlueprintType)
+struct FDTTimerPhase
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dynamic Timers")
+	FGameplayTag PhaseTag;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dynamic Timers", meta = (ClampMin = "0.0"))
+	float Duration = 0.0f;
+};
+
+// Where a running timer is within its loop and phases, derived from its elapsed time
+struct FDTTimerPosition
+{
+	int32 Loop = 0;
+
+	// INDEX_NONE for timers without phases
+	int32 PhaseIndex = INDEX_NONE;
+
+	// Thresholds of the current loop the remaining time has come down to
+	int32 NumThresholdsReached = 0;
+
+	// Elapsed time at which the current phase, the current loop or the next threshold comes
+	double BoundaryTime = 0.0;
+};
+
 USTRUCT(BlueprintType)
-struct FTimeData
+struct FTimeData : public FFastArraySerializerItem
 {
 	GENERATED_BODY()
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Dynamic Timers")
 	FGameplayTag TimerTag;
 
+	// Server time (see UDynamicTimersComponent::GetServerTime) the countdown started at
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Dynamic Timers")
+	double StartTime = 0.0;
+
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Dynamic Timers")
-	float StartTime = 0.0f;
+	bool bIsStarted = false;
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Dynamic Timers")
 	float Duration = 0.0f;
@@ -27,11 +148,211 @@ struct FTimeData
 	//UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Dynamic Timers")
 	//bool bPersistForJoinInProgress = true;
 
+	// Relevancy is decided on the server. Clients only learn whether a timer is their player's own or a team timer,
+	// which is what prediction needs; TeamId and OwningPlayer are not sent.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Dynamic Timers")
+	EDTTimerScope Scope = EDTTimerScope::Global;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Dynamic Timers")
+	uint8 TeamId = DynamicTimers::NoTeam;
+
+	// Starts over instead of finishing. Clients work out the current loop from StartTime, so loops cost no traffic.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Dynamic Timers")
+	bool bLooping = false;
+
+	// Steps of a sequence, run back to back; Duration is their sum. Like loops, phase changes are derived locally.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Dynamic Timers")
+	TArray<FDTTimerPhase> Phases;
+
+	// Remaining times, largest first, at which every machine fires OnTimerThresholdReached from its own clock.
+	// They travel with the timer's replicated state; reaching one sends nothing.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Dynamic Timers")
+	TArray<float> Thresholds;
+
+	// Timer seconds per second of server time. Changing it rebases StartTime, so clients evaluate
+	// the elapsed time as (server time - StartTime) * Rate with no further updates.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Dynamic Timers")
+	float Rate = 1.0f;
+
+	// Server only: the speed gameplay asked for, and whether world time dilation applies on top of it.
+	// Rate is TimeScale, divided by the world's time dilation for timers that ignore it.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Dynamic Timers")
+	float TimeScale = 1.0f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Dynamic Timers")
+	bool bIgnoreTimeDilation = false;
+
+	// Server only, for player scoped timers
+	TWeakObjectPtr<APlayerController> OwningPlayer;
+
+	// Last client prediction the server applied to this timer. Sent back so the predicting client
+	// can tell when the replicated state includes its prediction; 0 when there is none.
+	uint16 PredictionId = 0;
+
+	// Bumped, wrapping, each time an actor timer is started over while it was already started. A restart can
+	// otherwise look like no change, or like a resume, once several updates land in one net update.
+	uint8 RestartCount = 0;
+
+	// Position in the timer catalog for timers registered from a definition, which replicate this in place of
+	// their tag, duration, phases and thresholds. Cleared when any of those change afterwards.
+	int32 DefinitionIndex = INDEX_NONE;
+
 	bool operator==(const FTimeData& Other) const
 	{
 		return TimerTag == Other.TimerTag;
 	}
-	
+
+	bool IsRunning() const { return bIsStarted && !bIsPaused; }
+
+	bool HasBoundaries() const { return bLooping || !Phases.IsEmpty() || !Thresholds.IsEmpty(); }
+
+	// Started for a server time that has not come yet; the elapsed time stays at zero until then
+	bool IsWaitingToStart(double ServerTime) const { return IsRunning() && StartTime > ServerTime; }
+
+	double GetElapsedTime(double ServerTime) const;
+
+	// Server time at which a running timer reaches the given elapsed time
+	double GetServerTimeAtElapsed(double ElapsedTime) const { return StartTime + ElapsedTime / Rate; }
+
+	FDTTimerPosition GetPosition(double ElapsedTime) const;
+
+	// Seconds left at the given server time, never negative
+	float GetRemainingTime(double ServerTime) const;
+
+	// Copies a sequence onto a timer being registered; Duration becomes the length of the sequence
+	bool SetPhases(TConstArrayView<FDTTimerPhase> InPhases);
+
+	// Keeps the thresholds a run of the timer can come down to, largest first
+	void SetThresholds(TConstArrayView<float> InThresholds);
+
+	// Takes the static data of a catalog definition, leaving the state alone
+	void CopyDefinitionFrom(const FTimeData& Prototype);
+
+	// Sends the tag as its net index, the state and whether the timer is player scoped as flag bits and times quantized to the configured net resolution.
+	// StartTime only travels while running and ElapsedTimeWhenPaused only while paused. Sequences send their
+	// phases instead of Duration, which the receiver sums up again. Rate, PredictionId, RestartCount and thresholds are only sent when set.
+	// Catalog timers send their definition index instead of the tag, duration, phases and thresholds.
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+
+	// Fast array callbacks, forwarded to the owning component on clients
+	void PreReplicatedRemove(const FDTTimerArray& InArraySerializer);
+	void PostReplicatedAdd(const FDTTimerArray& InArraySerializer);
+	void PostReplicatedChange(const FDTTimerArray& InArraySerializer);
+
+	void PreReplicatedRemove(const FDTRelevantTimerArray& InArraySerializer);
+	void PostReplicatedAdd(const FDTRelevantTimerArray& InArraySerializer);
+	void PostReplicatedChange(const FDTRelevantTimerArray& InArraySerializer);
+
+	void PreReplicatedRemove(const FDTActorTimerArray& InArraySerializer);
+	void PostReplicatedAdd(const FDTActorTimerArray& InArraySerializer);
+	void PostReplicatedChange(const FDTActorTimerArray& InArraySerializer);
+
+	// Copies another timer's state while keeping this item's fast array bookkeeping and notified flags
+	void CopyStateFrom(const FTimeData& Other);
+
+	// Last state events were broadcast for. Not replicated, so it survives delta updates and lets
+	// the owner fire only the transitions it has not reported yet.
+	bool bNotifiedStarted = false;
+	bool bNotifiedPaused = false;
+	int32 NotifiedPhaseIndex = INDEX_NONE;
+	int32 NotifiedLoop = INDEX_NONE;
+	int32 NotifiedThresholds = 0;
+	uint8 NotifiedRestartCount = 0;
+};
+
+template<>
+struct TStructOpsTypeTraits<FTimeData> : public TStructOpsTypeTraitsBase2<FTimeData>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
+
+// The game state only streams global timers; team and player timers go through FDTRelevantTimerArray
+template<>
+inline bool ShouldWriteFastArrayItem<FTimeData, FDTTimerArray>(const FTimeData& Item, const bool bIsWritingOnClient)
+{
+	if (bIsWritingOnClient)
+	{
+		return Item.ReplicationID != INDEX_NONE;
+	}
+	return Item.Scope == EDTTimerScope::Global;
+}
+
+USTRUCT()
+struct FDTTimerArray : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<FTimeData> Items;
+
+	// Set by the owning component in PostInitProperties
+	UDynamicTimersComponent* Owner = nullptr;
+
+	void PostReplicatedReceive(const FFastArraySerializer::FPostReplicatedReceiveParameters& Parameters);
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms);
+};
+
+template<>
+struct TStructOpsTypeTraits<FDTTimerArray> : public TStructOpsTypeTraitsBase2<FDTTimerArray>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
+
+// Scoped timers relevant to one connection, replicated to its owner only
+USTRUCT()
+struct FDTRelevantTimerArray : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<FTimeData> Items;
+
+	// Set by the owning player component in PostInitProperties
+	UDynamicTimersPlayerComponent* Owner = nullptr;
+
+	void PostReplicatedReceive(const FFastArraySerializer::FPostReplicatedReceiveParameters& Parameters);
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms);
+};
+
+template<>
+struct TStructOpsTypeTraits<FDTRelevantTimerArray> : public TStructOpsTypeTraitsBase2<FDTRelevantTimerArray>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
+
+// Timers of one actor held by UDynamicTimersSubsystem, replicated wherever the actor is relevant
+USTRUCT()
+struct FDTActorTimerArray : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<FTimeData> Items;
+
+	// Set by the owning actor timers component in PostInitProperties
+	UDynamicActorTimersComponent* Owner = nullptr;
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms);
+};
+
+template<>
+struct TStructOpsTypeTraits<FDTActorTimerArray> : public TStructOpsTypeTraitsBase2<FDTActorTimerArray>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
 };
 
 USTRUCT(BlueprintType)
@@ -47,4 +368,47 @@ struct FBulkTimerRegistrationData
 
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Dynamic Timers")
 	bool bPersistForJoinInProgress = true;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Dynamic Timers")
+	EDTTimerScope Scope = EDTTimerScope::Global;
+
+	// Team the timer replicates to when Scope is Team
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Dynamic Timers")
+	uint8 TeamId = DynamicTimers::NoTeam;
+
+	// Player the timer replicates to when Scope is Player
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Dynamic Timers")
+	TObjectPtr<APlayerController> OwningPlayer = nullptr;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Dynamic Timers")
+	bool bLooping = false;
+
+	// When set, Duration is ignored and the timer runs these steps in order
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Dynamic Timers")
+	TArray<FDTTimerPhase> Phases;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Dynamic Timers", meta = (ClampMin = "0.001"))
+	float TimeScale = 1.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Dynamic Timers")
+	bool bIgnoreTimeDilation = false;
+
+	// Remaining times that fire OnTimerThresholdReached, e.g. 60, 10 and 5 for countdown warnings
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Dynamic Timers")
+	TArray<float> Thresholds;
+};
+
+USTRUCT(BlueprintType)
+struct FDTRemainingTime
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "Dynamic Timers")
+	FGameplayTag TimerTag;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Dynamic Timers")
+	float RemainingTime = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Dynamic Timers")
+	bool bIsRunning = false;
 };
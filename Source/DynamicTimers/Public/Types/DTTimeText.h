@@ -0,0 +1,41 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DTTimeText.generated.h"
+
+UENUM(BlueprintType)
+enum class EDTTimeFormat : uint8
+{
+	MinutesSeconds			UMETA(DisplayName = "MM:SS"),
+	HoursMinutesSeconds		UMETA(DisplayName = "HH:MM:SS"),
+	SecondsTenths			UMETA(DisplayName = "SS.t"),
+	MinutesSecondsMillis	UMETA(DisplayName = "MM:SS.mmm")
+};
+
+/**
+ * Last text produced for one timer display. The text is only rebuilt when the value it shows changes,
+ * so a binding that updates every frame costs a compare on most frames.
+ */
+USTRUCT(BlueprintType)
+struct DYNAMICTIMERS_API FDTTimeTextCache
+{
+	GENERATED_BODY()
+
+	const FText& Update(double TotalSeconds, EDTTimeFormat Format);
+
+	void Reset();
+
+	// Formats without caching; values are floored to the smallest unit the format shows
+	static FText FormatTime(double TotalSeconds, EDTTimeFormat Format);
+
+private:
+	// Value in the smallest unit of the format, e.g. tenths for SS.t
+	static int64 ToDisplayedUnits(double TotalSeconds, EDTTimeFormat Format);
+	static FText BuildText(int64 DisplayedUnits, EDTTimeFormat Format);
+
+	FText Text;
+
+	int64 DisplayedUnits = INDEX_NONE;
+
+	EDTTimeFormat DisplayedFormat = EDTTimeFormat::MinutesSeconds;
+};
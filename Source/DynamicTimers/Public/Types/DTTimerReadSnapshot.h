@@ -0,0 +1,64 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+#include <atomic>
+
+struct FTimeData;
+
+/**
+ * Copy of a component's timers that any thread can query without locks and without going through the game thread.
+ * The game thread publishes into one of two buffers while readers use the other. A reader registers on the buffer
+ * it reads, and a publish that would overwrite a buffer still in use is held back rather than waited for.
+ * Readers work out the server time from a clock anchor the game thread refreshes every frame.
+ */
+struct DYNAMICTIMERS_API FDTTimerReadSnapshot
+{
+	// Game thread. Returns false if a reader still holds the spare buffer, in which case nothing changed.
+	// LocalTimers are the scoped timers a client keeps next to the replicated ones.
+	bool Publish(TConstArrayView<FTimeData> Timers, TConstArrayView<FTimeData> LocalTimers = {});
+
+	// Game thread, once per frame. ClockRate is server seconds per real second: the time dilation, 0 while paused.
+	void UpdateClock(double ServerTime, double ClockRate);
+
+	// Any thread
+	double GetServerTime() const;
+	bool GetRemainingTime(const FGameplayTag& TimerTag, float& OutRemainingTime) const;
+	bool IsTimerRunning(const FGameplayTag& TimerTag) const;
+	int32 GetNumTimers() const;
+
+private:
+	// The parts of FTimeData that the remaining time depends on
+	struct FEntry
+	{
+		double StartTime = 0.0;
+		float Duration = 0.0f;
+		float ElapsedTimeWhenPaused = 0.0f;
+		float Rate = 1.0f;
+		bool bIsStarted = false;
+		bool bIsPaused = false;
+		bool bLooping = false;
+
+		float GetRemainingTime(double ServerTime) const;
+	};
+
+	struct FBuffer
+	{
+		// Reset and refilled on publish, so the allocation is kept once the timer count settles
+		TMap<FGameplayTag, FEntry> Entries;
+		std::atomic<int32> NumReaders{ 0 };
+	};
+
+	// Calls Reader with the published entries, keeping their buffer from being republished meanwhile
+	template<typename ReaderType>
+	auto Read(ReaderType&& Reader) const;
+
+	mutable FBuffer Buffers[2];
+	std::atomic<int32> PublishedIndex{ 0 };
+
+	// Odd while the game thread writes the anchor
+	std::atomic<uint32> ClockSequence{ 0 };
+	std::atomic<double> AnchorServerTime{ 0.0 };
+	std::atomic<double> AnchorPlatformTime{ 0.0 };
+	std::atomic<double> AnchorClockRate{ 0.0 };
+};
@@ -4,29 +4,66 @@
 
 #include "CoreMinimal.h"
 #include "GameplayTagContainer.h"
+#include "Blueprint/IUserObjectListEntry.h"
 #include "Blueprint/UserWidget.h"
+#include "Types/DTTimeText.h"
 #include "TimerDisplayWidget.generated.h"
 
+class UDynamicTimersComponent;
+
 /**
  * 
  */
 UCLASS()
-class DYNAMICTIMERS_API UTimerDisplayWidget : public UUserWidget
+class DYNAMICTIMERS_API UTimerDisplayWidget : public UUserWidget, public IUserObjectListEntry
 {
 	GENERATED_BODY()
 public:
 
 	void SetTimerTag(FGameplayTag InTag);
 
+	FGameplayTag GetTimerTag() const { return TimerTag; }
+
+	void SetTimerActive(bool bIsActive);
+
 	UFUNCTION(BlueprintImplementableEvent, Category = "Dynamic Timers")
 	void OnTimerActivated();
 
 	UFUNCTION(BlueprintImplementableEvent, Category = "Dynamic Timers")
 	void OnTimerDeactivated();
 
+	// Called by the timers component's display update pass; forwards to OnRemainingTimeUpdated by default
+	virtual void NativeOnRemainingTimeUpdated(float RemainingTime);
+
+	UFUNCTION(BlueprintImplementableEvent, Category = "Dynamic Timers")
+	void OnRemainingTimeUpdated(float RemainingTime);
+
+	// Text for RemainingTime in TimeFormat, rebuilt only when the displayed value changes
+	UFUNCTION(BlueprintCallable, Category = "Dynamic Timers")
+	FText FormatRemainingTime(float RemainingTime);
+
 protected:
 
+	virtual void NativeConstruct() override;
+	virtual void NativeDestruct() override;
+
+	// Used when the widget is an entry of UTimerManagerWidget's list view
+	virtual void NativeOnListItemObjectSet(UObject* ListItemObject) override;
+
 	UPROPERTY(BlueprintReadOnly, Category = "Dynamic Timers")
 	FGameplayTag TimerTag;
 
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Dynamic Timers")
+	EDTTimeFormat TimeFormat = EDTTimeFormat::MinutesSeconds;
+
+	// Register with the game state's timers component on construct instead of polling for the remaining time
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Dynamic Timers")
+	bool bReceiveRemainingTimeUpdates = true;
+
+private:
+
+	FDTTimeTextCache RemainingTimeText;
+
+	TWeakObjectPtr<UDynamicTimersComponent> TimersComponent;
+
 };
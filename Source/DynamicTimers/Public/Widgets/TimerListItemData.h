@@ -0,0 +1,26 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+#include "UObject/Object.h"
+#include "TimerListItemData.generated.h"
+
+/**
+ * Row data for UTimerManagerWidget's virtualized list mode. Items are recycled by the manager,
+ * entry widgets only exist for the rows currently on screen.
+ */
+UCLASS(BlueprintType)
+class DYNAMICTIMERS_API UTimerListItemData : public UObject
+{
+	GENERATED_BODY()
+
+public:
+
+	UPROPERTY(BlueprintReadOnly, Category = "Dynamic Timers")
+	FGameplayTag TimerTag;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Dynamic Timers")
+	bool bIsActive = false;
+};
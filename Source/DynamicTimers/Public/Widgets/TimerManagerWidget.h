@@ -5,51 +5,69 @@
 #include "CoreMinimal.h"
 #include "TimerDisplayWidget.h"
 #include "Blueprint/UserWidget.h"
-#include "Game/CommonGameState.h"
-#include "GameFramework/GameState.h"
+#include "Blueprint/UserWidgetPool.h"
 #include "TimerManagerWidget.generated.h"
 
+class UDynamicTimersComponent;
+class UListView;
+class UTimerListItemData;
+
 /**
- * 
+ * Shows one UTimerDisplayWidget per timer. Display widgets are recycled through a pool; binding a
+ * TimersListView switches to a virtualized list where only the visible rows get a widget.
  */
 UCLASS()
 class DYNAMICTIMERS_API UTimerManagerWidget : public UUserWidget
 {
 	GENERATED_BODY()
 
+public:
+
+	UTimerManagerWidget(const FObjectInitializer& ObjectInitializer);
+
+	virtual void ReleaseSlateResources(bool bReleaseChildren) override;
+
 protected:
 
 	virtual void NativeConstruct() override;
 	virtual void NativeDestruct() override;
 
-	UPROPERTY(meta = (BindWidget))
+	UPROPERTY(meta = (BindWidgetOptional))
 	UPanelWidget* TimersContainer;
 
+	// For views with many timers. Its entry class must be a UTimerDisplayWidget.
+	UPROPERTY(meta = (BindWidgetOptional))
+	UListView* TimersListView;
+
 	UPROPERTY(EditDefaultsOnly, Category="Dynamic Timers | Widgets")
 	TSubclassOf<UTimerDisplayWidget> TimerDisplayWidgetClass;
 
 private:
 
-	UFUNCTION()
-	void HandleTimerRegistered(FGameplayTag TimerTag, float Duration);
+	// Native subscription, limited to FilterTimerTag when one is set
+	void HandleTimerEvent(const FDTTimerEventData& EventData);
 
-	UFUNCTION()
-	void HandleTimerStarted(FGameplayTag TimerTag, float Duration);
+	void HandleTimerRegistered(const FGameplayTag& TimerTag);
+	void HandleTimerFinished(const FGameplayTag& TimerTag);
 
-	UFUNCTION()
-	void HandleTimerFinished(FGameplayTag TimerTag);
+	void SetTimerActive(const FGameplayTag& TimerTag, bool bIsActive);
 
-	UFUNCTION()
-	void HandleTimerPaused(FGameplayTag TimerTag);
+	UPROPERTY()
+	TMap<FGameplayTag, UTimerDisplayWidget*> ActiveTimerWidgets;
 
-	UFUNCTION()
-	void HandleTimerResumed(FGameplayTag TimerTag);
+	UPROPERTY(Transient)
+	FUserWidgetPool TimerWidgetPool;
 
+	// List view mode
 	UPROPERTY()
-	TMap<FGameplayTag, UTimerDisplayWidget*> ActiveTimerWidgets;
+	TMap<FGameplayTag, TObjectPtr<UTimerListItemData>> ActiveTimerItems;
 
 	UPROPERTY()
-	TObjectPtr<AGameStateBase> CachedGameState;
+	TArray<TObjectPtr<UTimerListItemData>> PooledTimerItems;
+
+	TWeakObjectPtr<UDynamicTimersComponent> TimersComponent;
+
+	FDelegateHandle TimerEventsHandle;
 
 	UPROPERTY(EditAnywhere, Category="Dynamic Timers | Settings")
 	FGameplayTag FilterTimerTag;